@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+#include <string>
+
+#include "simd.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// liczba ustawionych bitów w słowie
+inline std::size_t bitCount(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    return static_cast<std::size_t>(__popcnt64(word));
+#else
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#endif
+}
+
+// indeks najmłodszego ustawionego bitu (słowo nie może być zerem)
+inline std::size_t bitScanForward(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index,word);
+    return static_cast<std::size_t>(index);
+#else
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#endif
+}
+
+// indeks najstarszego ustawionego bitu (słowo nie może być zerem)
+inline std::size_t bitScanReverse(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index,word);
+    return static_cast<std::size_t>(index);
+#else
+    return static_cast<std::size_t>(63-__builtin_clzll(word));
+#endif
+}
+
+#if defined(GRAPH_SIMD_AVX2)
+// dst |= src dla początkowych słów, po 4 naraz - zwraca liczbę przetworzonych słów
+inline GRAPH_SIMD_TARGET("avx2") std::size_t bitsOrAvx2(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for(;i+4<=n;i+=4)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst+i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i),_mm256_or_si256(a,b));
+    }
+    return i;
+}
+
+// popcount bajtów z tablicy dla półbajtów (vpshufb), sumowany przez vpsadbw
+// liczy początkowe słowa, po 4 naraz - "i" to liczba przetworzonych słów
+inline GRAPH_SIMD_TARGET("avx2,popcnt") std::size_t bitsAndCountAvx2(const std::uint64_t* a, const std::uint64_t* b,
+                                                                      std::size_t n, std::size_t& i)
+{
+    const __m256i lookup = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                            0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+    __m256i sum = _mm256_setzero_si256();
+    for(i=0;i+4<=n;i+=4)
+    {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a+i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b+i));
+        __m256i v = _mm256_and_si256(va,vb);
+        __m256i counts = _mm256_add_epi8(
+                    _mm256_shuffle_epi8(lookup,_mm256_and_si256(v,lowNibbles)),
+                    _mm256_shuffle_epi8(lookup,_mm256_and_si256(_mm256_srli_epi16(v,4),lowNibbles)));
+        sum = _mm256_add_epi64(sum,_mm256_sad_epu8(counts,_mm256_setzero_si256()));
+    }
+    return static_cast<std::size_t>(_mm256_extract_epi64(sum,0)+_mm256_extract_epi64(sum,1)+
+                                    _mm256_extract_epi64(sum,2)+_mm256_extract_epi64(sum,3));
+}
+#endif
+
+#if defined(GRAPH_SIMD_AVX512_POPCOUNT)
+// AVX-512 VPOPCNTDQ: popcount 8 słów naraz - "i" to liczba przetworzonych słów
+inline GRAPH_SIMD_TARGET("avx512f,avx512vpopcntdq,popcnt") std::size_t bitsAndCountAvx512(
+        const std::uint64_t* a, const std::uint64_t* b, std::size_t n, std::size_t& i)
+{
+    __m512i sum = _mm512_setzero_si512();
+    for(i=0;i+8<=n;i+=8)
+    {
+        __m512i va = _mm512_loadu_si512(a+i);
+        __m512i vb = _mm512_loadu_si512(b+i);
+        sum = _mm512_add_epi64(sum,_mm512_popcnt_epi64(_mm512_and_si512(va,vb)));
+    }
+    return static_cast<std::size_t>(_mm512_reduce_add_epi64(sum));
+}
+#endif
+
+// dst |= src dla "n" słów
+inline void bitsOr(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+#if defined(GRAPH_SIMD_AVX2)
+    if(cpuSupportsAvx2()) i = bitsOrAvx2(dst,src,n);
+#endif
+    for(;i<n;++i)
+    {
+        dst[i] |= src[i];
+    }
+}
+
+// liczba bitów ustawionych jednocześnie w "a" i "b"
+// najszersza ścieżka obsługiwana przez procesor: AVX-512 VPOPCNTDQ, AVX2, słowo po słowie
+inline std::size_t bitsAndCount(const std::uint64_t* a, const std::uint64_t* b, std::size_t n)
+{
+    std::size_t result = 0;
+    std::size_t i = 0;
+#if defined(GRAPH_SIMD_AVX512_POPCOUNT)
+    if(cpuSupportsAvx512Popcount()) result = bitsAndCountAvx512(a,b,n,i);
+#endif
+#if defined(GRAPH_SIMD_AVX2)
+    // bez AVX-512 (lub gdy słów jest mniej niż 8)
+    if(i==0 && cpuSupportsAvx2()) result = bitsAndCountAvx2(a,b,n,i);
+#endif
+    for(;i<n;++i)
+    {
+        result += bitCount(a[i]&b[i]);
+    }
+    return result;
+}
+
+// macierz bitowa, każdy wiersz upakowany w słowa 64-bitowe
+class BitMatrix
+{
+public:
+    static constexpr std::size_t WORD_BITS = 64;
+
+    BitMatrix()
+        :mRows(0),mCols(0),mWordsPerRow(0)
+    {
+
+    }
+
+    BitMatrix(std::size_t rows, std::size_t cols)
+        :mRows(rows),mCols(cols),mWordsPerRow((cols+WORD_BITS-1)/WORD_BITS),
+          mWords(rows*mWordsPerRow,0)
+    {
+
+    }
+
+    std::size_t rows() const
+    {
+        return this->mRows;
+    }
+    std::size_t cols() const
+    {
+        return this->mCols;
+    }
+    std::size_t wordsPerRow() const
+    {
+        return this->mWordsPerRow;
+    }
+
+    bool test(std::size_t y, std::size_t x) const
+    {
+        return (this->row(y)[x/WORD_BITS]>>(x%WORD_BITS))&1u;
+    }
+    void set(std::size_t y, std::size_t x)
+    {
+        this->row(y)[x/WORD_BITS] |= std::uint64_t(1)<<(x%WORD_BITS);
+    }
+    void reset(std::size_t y, std::size_t x)
+    {
+        this->row(y)[x/WORD_BITS] &= ~(std::uint64_t(1)<<(x%WORD_BITS));
+    }
+
+    std::uint64_t* row(std::size_t y)
+    {
+        return this->mWords.data()+y*this->mWordsPerRow;
+    }
+    const std::uint64_t* row(std::size_t y) const
+    {
+        return this->mWords.data()+y*this->mWordsPerRow;
+    }
+
+    // wiersz "dst" |= wiersz "src"
+    void orRow(std::size_t dst, std::size_t src)
+    {
+        bitsOr(this->row(dst),this->row(src),this->mWordsPerRow);
+    }
+
+    // liczba ustawionych bitów w wierszu
+    std::size_t rowCount(std::size_t y) const
+    {
+        const std::uint64_t* r = this->row(y);
+        std::size_t result = 0;
+        for(std::size_t i=0;i<this->mWordsPerRow;++i)
+        {
+            result += bitCount(r[i]);
+        }
+        return result;
+    }
+
+    // zwraca pamięć zajmowaną przez bity (w bajtach)
+    std::size_t memoryUsage() const
+    {
+        return this->mWords.size()*sizeof(std::uint64_t);
+    }
+private:
+    std::size_t mRows;
+    std::size_t mCols;
+    std::size_t mWordsPerRow;
+    std::vector<std::uint64_t> mWords;
+};
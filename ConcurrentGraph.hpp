@@ -0,0 +1,209 @@
+#pragma once
+#include "Graph.hpp"
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// graf z izolacją migawek dla współbieżnych czytelników (MVCC / RCU)
+// czytelnicy biorą niezmienną migawkę ("snapshot()") i wykonują na niej zapytania bez blokad,
+// pisarze wykonują paczkę zmian na kopii aktualnej wersji i publikują nową wersję atomowo
+// stare wersje są zwalniane, gdy żaden czytelnik nie może już ich widzieć (epoki)
+// migawki muszą zostać zwolnione przed zniszczeniem obiektu ConcurrentGraph
+template<typename V, typename E>
+class ConcurrentGraph
+{
+public:
+    // uchwyt do niezmiennej wersji grafu, ważny do zniszczenia uchwytu
+    class Snapshot
+    {
+        friend class ConcurrentGraph;
+
+        Snapshot(const ConcurrentGraph* owner, std::size_t slot, const Graph<V, E>* graph)
+            :mOwner(owner),mSlot(slot),mGraph(graph)
+        {
+
+        }
+    public:
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot(Snapshot&& source)
+            :mOwner(source.mOwner),mSlot(source.mSlot),mGraph(source.mGraph)
+        {
+            source.mOwner = nullptr;
+        }
+        Snapshot& operator=(Snapshot&& source)
+        {
+            if(this!=&source)
+            {
+                this->mRelease();
+                this->mOwner = source.mOwner;
+                this->mSlot = source.mSlot;
+                this->mGraph = source.mGraph;
+                source.mOwner = nullptr;
+            }
+            return *this;
+        }
+        ~Snapshot()
+        {
+            this->mRelease();
+        }
+
+        const Graph<V, E>& operator*() const
+        {
+            return *this->mGraph;
+        }
+        const Graph<V, E>* operator->() const
+        {
+            return this->mGraph;
+        }
+    private:
+        const ConcurrentGraph* mOwner;
+        std::size_t mSlot;
+        const Graph<V, E>* mGraph;
+
+        void mRelease()
+        {
+            if(this->mOwner!=nullptr)
+            {
+                this->mOwner->mSlots[this->mSlot].epoch.store(FREE_SLOT);
+                this->mOwner = nullptr;
+            }
+        }
+    };
+
+    // "maxReaders" - liczba migawek, które mogą istnieć jednocześnie bez czekania
+    explicit ConcurrentGraph(Graph<V, E> graph = Graph<V, E>(), std::size_t maxReaders = 128)
+        :mCurrent(new Graph<V, E>(std::move(graph))),
+          mEpoch(1),
+          mSlotsNumber(std::max<std::size_t>(maxReaders,1)),
+          mSlots(new Slot[mSlotsNumber])
+    {
+
+    }
+    ConcurrentGraph(const ConcurrentGraph&) = delete;
+    ConcurrentGraph& operator=(const ConcurrentGraph&) = delete;
+    ~ConcurrentGraph()
+    {
+        delete this->mCurrent.load();
+    }
+
+    // zwraca migawkę aktualnej wersji grafu
+    // bez czekania, dopóki istnieje mniej niż "maxReaders" migawek
+    Snapshot snapshot() const
+    {
+        std::size_t slot = this->mClaimSlot();
+        this->mSlots[slot].epoch.store(this->mEpoch.load());
+        return Snapshot(this,slot,this->mCurrent.load());
+    }
+
+    // wykonuje paczkę zmian na kopii aktualnej wersji i publikuje wynik jako nową wersję
+    // pisarze są szeregowani, czytelnicy nigdy nie czekają na pisarzy
+    void update(const std::function<void(Graph<V, E>&)>& batch)
+    {
+        std::lock_guard<std::mutex> lock(this->mWriterMutex);
+        std::unique_ptr<Graph<V, E>> next(new Graph<V, E>(*this->mCurrent.load()));
+        batch(*next);
+        this->mPublish(std::move(next));
+    }
+
+    // "update()" wykonujące "Graph::applyEdgeBatch()" - zmiany jednej paczki są wykonywane równolegle,
+    // kopiowane są tylko zmieniane wiersze; zwraca liczbę zmian, które zmieniły graf
+    std::size_t applyEdgeBatch(const std::vector<typename Graph<V, E>::EdgeUpdate>& updates,
+                               std::size_t threadsNumber = 0)
+    {
+        std::size_t changes = 0;
+        this->update([&](Graph<V, E>& graph)
+        {
+            changes = graph.applyEdgeBatch(updates,threadsNumber);
+        });
+        return changes;
+    }
+
+    // zastępuje graf nową wersją (np. po ponownym wczytaniu)
+    void publish(Graph<V, E> graph)
+    {
+        std::lock_guard<std::mutex> lock(this->mWriterMutex);
+        this->mPublish(std::unique_ptr<Graph<V, E>>(new Graph<V, E>(std::move(graph))));
+    }
+
+    // zwalnia stare wersje, których nie widzi już żaden czytelnik
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock(this->mWriterMutex);
+        this->mReclaim();
+    }
+
+    // zwraca liczbę starych wersji czekających na zwolnienie
+    std::size_t retiredNumber() const
+    {
+        std::lock_guard<std::mutex> lock(this->mWriterMutex);
+        return this->mRetired.size();
+    }
+private:
+    static constexpr std::uint64_t FREE_SLOT = std::numeric_limits<std::uint64_t>::max();
+
+    class alignas(64) Slot
+    {
+    public:
+        std::atomic<std::uint64_t> epoch{FREE_SLOT};
+    };
+
+    std::atomic<const Graph<V, E>*> mCurrent;
+    std::atomic<std::uint64_t> mEpoch;
+    std::size_t mSlotsNumber;
+    std::unique_ptr<Slot[]> mSlots;
+
+    mutable std::mutex mWriterMutex;
+    // stara wersja i epoka, od której nowi czytelnicy już jej nie widzą
+    std::vector<std::pair<std::uint64_t, std::unique_ptr<const Graph<V, E>>>> mRetired;
+
+    // Zajęty slot ma epokę 0 do czasu zapisania właściwej epoki - blokuje wtedy zwalnianie wszystkich wersji.
+    // Sloty są przeszukywane od pozycji zależnej od wątku, żeby czytelnicy nie rywalizowali o te same.
+    std::size_t mClaimSlot() const
+    {
+        const std::size_t first = std::hash<std::thread::id>()(std::this_thread::get_id())%this->mSlotsNumber;
+        while(true)
+        {
+            for(std::size_t i=0;i<this->mSlotsNumber;++i)
+            {
+                std::size_t slot = (first+i)%this->mSlotsNumber;
+                std::uint64_t expected = FREE_SLOT;
+                if(this->mSlots[slot].epoch.compare_exchange_strong(expected,0))
+                {
+                    return slot;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void mPublish(std::unique_ptr<Graph<V, E>> next)
+    {
+        const Graph<V, E>* previous = this->mCurrent.exchange(next.release());
+        std::uint64_t retiredAt = this->mEpoch.fetch_add(1)+1;
+        this->mRetired.emplace_back(retiredAt,std::unique_ptr<const Graph<V, E>>(previous));
+        this->mReclaim();
+    }
+
+    void mReclaim()
+    {
+        std::uint64_t oldestReader = FREE_SLOT;
+        for(std::size_t i=0;i<this->mSlotsNumber;++i)
+        {
+            oldestReader = std::min(oldestReader,this->mSlots[i].epoch.load());
+        }
+
+        std::size_t kept = 0;
+        for(std::size_t i=0;i<this->mRetired.size();++i)
+        {
+            if(this->mRetired[i].first>oldestReader)
+            {
+                this->mRetired[kept++] = std::move(this->mRetired[i]);
+            }
+        }
+        this->mRetired.resize(kept);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graph.hpp"
+#include "tracing.hpp"
 #include <functional>
 #include <stack>
 #include <queue>
@@ -9,6 +10,7 @@ template<typename V,typename E>
 void DFS(const Graph<V,E>&g,std::size_t startID,
          std::function<void(const V&) > f)
 {
+    GRAPH_TRACE_SPAN(span,"traversal","DFS");
     std::size_t verticesNumber = g.nrOfVertices();
     if(startID>=verticesNumber)
         throw std::runtime_error(std::string("[DFS] Incorrect startID:")
@@ -45,6 +47,7 @@ template<typename V,typename E>
 void BFS(const Graph<V,E>&g,std::size_t startID,
          std::function<void(const V&) > f)
 {
+    GRAPH_TRACE_SPAN(span,"traversal","BFS");
     std::size_t verticesNumber = g.nrOfVertices();
     if(startID>=verticesNumber)
         throw std::runtime_error(std::string("[BFS] Incorrect startID:")
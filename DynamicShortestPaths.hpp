@@ -0,0 +1,355 @@
+#pragma once
+#include "Graph.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+// najkrótsze ścieżki z jednego źródła utrzymywane przy zmianach grafu (w stylu Ramalingama-Repsa)
+// zmiany są odczytywane z dziennika grafu ("Graph::structureChangesSince()") przy każdym zapytaniu, a naprawiana
+// jest tylko część drzewa najkrótszych ścieżek, na którą zmienione krawędzie mają wpływ
+// (koszt aktualizacji zależy od liczby zmian, naprawianego poddrzewa i jego krawędzi, a nie od liczby wierzchołków)
+// długości krawędzi muszą być nieujemne
+// usunięcie wierzchołka lub utrata dziennika (przepełnienie) przy niezmienionej numeracji wierzchołków
+// powodują pełne przeliczenie
+// usunięcie źródła, wyczyszczenie grafu, lub utrata dziennika razem ze zmianą numeracji ("Graph::permuteVertices()")
+// unieważniają obiekt - każde kolejne zapytanie zgłasza wyjątek
+template<typename V, typename E>
+class DynamicShortestPaths
+{
+public:
+    DynamicShortestPaths(Graph<V, E>& graph, std::size_t source,
+                         std::function<double(const E&)> getEdgeLength =
+                         [](const E&edge)->double{return edge;},
+                         std::size_t journalCapacity = 4096)
+        :mGraph(&graph),mSource(source),mGetEdgeLength(getEdgeLength),
+          mVersion(graph.version()),mIdsVersion(graph.idsVersion()),mLastUpdateSize(0)
+    {
+        if(graph.changeJournalCapacity()<journalCapacity)
+        {
+            graph.enableChangeJournal(journalCapacity);
+        }
+        this->mRecompute();
+    }
+
+    // zwraca długość najkrótszej ścieżki ze źródła do "vertex_id", lub std::numeric_limits<double>::max()
+    double distance(std::size_t vertex_id)
+    {
+        this->update();
+        this->mCheckVertex(vertex_id);
+        return this->mDistance[vertex_id];
+    }
+
+    // zwraca id wierzchołków najkrótszej ścieżki ze źródła do "vertex_id", lub pusty wektor
+    std::vector<std::size_t> path(std::size_t vertex_id)
+    {
+        this->update();
+        this->mCheckVertex(vertex_id);
+
+        std::vector<std::size_t> result;
+        if(this->mDistance[vertex_id]==MAX_DOUBLE_VALUE)return result;
+
+        for(std::size_t v = vertex_id; v!=this->mSource; v = this->mPrecursor[v])
+        {
+            result.push_back(v);
+        }
+        result.push_back(this->mSource);
+
+        std::reverse(result.begin(),result.end());
+        return result;
+    }
+
+    // przetwarza zmiany grafu od ostatniej aktualizacji
+    // zmiany są najpierw sprawdzane w całości - jeśli unieważniają obiekt, stan nie jest zmieniany
+    void update();
+
+    // id źródła (przesuwa się razem z usuwanymi wierzchołkami o mniejszych id)
+    std::size_t source() const
+    {
+        return this->mSource;
+    }
+    // zwraca liczbę wierzchołków przetworzonych przy ostatniej aktualizacji
+    std::size_t lastUpdateSize() const
+    {
+        return this->mLastUpdateSize;
+    }
+private:
+    static constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+    using QueueEntry = std::pair<double, std::size_t>;
+    using Queue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+    const Graph<V, E>* mGraph;
+    std::size_t mSource;
+    std::function<double(const E&)> mGetEdgeLength;
+    std::uint64_t mVersion;
+    std::uint64_t mIdsVersion;
+    std::size_t mLastUpdateSize;
+    // powód unieważnienia (pusty - obiekt jest ważny)
+    std::string mInvalidReason;
+
+    std::vector<double> mDistance;
+    std::vector<std::size_t> mPrecursor;
+    // dzieci wierzchołków w drzewie najkrótszych ścieżek
+    std::vector<std::vector<std::size_t>> mChildren;
+    // poprzednicy wierzchołków w grafie (graf przechowuje tylko wiersze macierzy)
+    std::vector<std::vector<std::size_t>> mInNeighbours;
+
+    std::size_t mNoPrecursor() const
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    void mRecompute();
+    std::size_t mPropagate(Queue& q1);
+
+    // zmienia poprzednika "vertex_id" w drzewie ścieżek, razem z listami dzieci
+    void mSetPrecursor(std::size_t vertex_id, std::size_t precursor)
+    {
+        const std::size_t previous = this->mPrecursor[vertex_id];
+        if(previous==precursor)return;
+        if(previous!=this->mNoPrecursor()) mErase(this->mChildren[previous],vertex_id);
+        if(precursor!=this->mNoPrecursor()) this->mChildren[precursor].push_back(vertex_id);
+        this->mPrecursor[vertex_id] = precursor;
+    }
+    // usuwa wartość z listy (kolejność listy nie jest zachowana)
+    static void mErase(std::vector<std::size_t>& list, std::size_t value)
+    {
+        auto it = std::find(list.begin(),list.end(),value);
+        if(it==list.end())return;
+        *it = list.back();
+        list.pop_back();
+    }
+
+    [[noreturn]] void mInvalidate(const std::string& reason)
+    {
+        this->mInvalidReason = "[Dynamic shortest paths] "+reason;
+        throw std::runtime_error(this->mInvalidReason);
+    }
+
+    void mCheckVertex(std::size_t vertex_id) const
+    {
+        if(vertex_id>=this->mDistance.size())
+        {
+            throw std::runtime_error("[Dynamic shortest paths] Incorrect vertex index: "
+                                     +std::to_string(vertex_id));
+        }
+    }
+};
+
+template<typename V, typename E>
+void DynamicShortestPaths<V,E>::mRecompute()
+{
+    const std::size_t verticesNumber = this->mGraph->nrOfVertices();
+    if(this->mSource>=verticesNumber)
+    {
+        throw std::runtime_error("[Dynamic shortest paths] Incorrect source index: "
+                                 +std::to_string(this->mSource));
+    }
+
+    this->mDistance.assign(verticesNumber,MAX_DOUBLE_VALUE);
+    this->mPrecursor.assign(verticesNumber,this->mNoPrecursor());
+    this->mChildren.assign(verticesNumber,std::vector<std::size_t>());
+    this->mInNeighbours.assign(verticesNumber,std::vector<std::size_t>());
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=this->mGraph->nextNeighbor(y,0);x<verticesNumber;x=this->mGraph->nextNeighbor(y,x+1))
+        {
+            this->mInNeighbours[x].push_back(y);
+        }
+    }
+    this->mIdsVersion = this->mGraph->idsVersion();
+    this->mDistance[this->mSource] = 0;
+
+    Queue q1;
+    q1.emplace(0.,this->mSource);
+    this->mLastUpdateSize = this->mPropagate(q1);
+}
+
+// Dijkstra od wierzchołków z kolejki, zwraca liczbę przetworzonych wierzchołków
+template<typename V, typename E>
+std::size_t DynamicShortestPaths<V,E>::mPropagate(Queue& q1)
+{
+    const std::size_t verticesNumber = this->mGraph->nrOfVertices();
+    std::size_t settled = 0;
+    while(!q1.empty())
+    {
+        auto [distance, vId] = q1.top();
+        q1.pop();
+        if(distance>this->mDistance[vId])continue;
+        ++settled;
+
+        for(std::size_t i=this->mGraph->nextNeighbor(vId,0);i<verticesNumber;i=this->mGraph->nextNeighbor(vId,i+1))
+        {
+            double newDistance = distance+this->mGetEdgeLength(this->mGraph->edgeLabel(vId,i));
+            if(newDistance<this->mDistance[i])
+            {
+                this->mDistance[i] = newDistance;
+                this->mSetPrecursor(i,vId);
+                q1.emplace(newDistance,i);
+            }
+        }
+    }
+    return settled;
+}
+
+template<typename V, typename E>
+void DynamicShortestPaths<V,E>::update()
+{
+    if(!this->mInvalidReason.empty())
+    {
+        throw std::runtime_error(this->mInvalidReason);
+    }
+    if(this->mVersion==this->mGraph->version())return;
+
+    using Change = typename Graph<V, E>::Change;
+    std::optional<std::vector<Change>> changes = this->mGraph->structureChangesSince(this->mVersion);
+
+    if(!changes.has_value())
+    {
+        // bez dziennika id źródła jest znane tylko wtedy, gdy numeracja wierzchołków się nie zmieniła
+        if(this->mGraph->idsVersion()!=this->mIdsVersion)
+        {
+            this->mInvalidate("Change journal was lost and vertex ids have changed");
+        }
+        this->mRecompute();
+        this->mVersion = this->mGraph->version();
+        return;
+    }
+
+    // 0. sprawdzenie całej partii zmian i nowe id źródła
+    std::size_t source = this->mSource;
+    bool recompute = false;
+    for(const Change& c: changes.value())
+    {
+        if(c.kind==Change::Cleared)
+        {
+            this->mInvalidate("Graph was cleared");
+        }
+        else if(c.kind==Change::VertexRemoved)
+        {
+            if(c.y==source)
+            {
+                this->mInvalidate("Source vertex was removed");
+            }
+            if(c.y<source) --source;
+            recompute = true;
+        }
+    }
+    this->mVersion = this->mGraph->version();
+    this->mSource = source;
+
+    if(recompute)
+    {
+        this->mRecompute();
+        return;
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> changedEdges;
+    for(const Change& c: changes.value())
+    {
+        if(c.kind==Change::VertexInserted)
+        {
+            this->mDistance.push_back(MAX_DOUBLE_VALUE);
+            this->mPrecursor.push_back(this->mNoPrecursor());
+            this->mChildren.emplace_back();
+            this->mInNeighbours.emplace_back();
+        }
+        else if(c.kind==Change::EdgeChanged)
+        {
+            changedEdges.emplace_back(c.y,c.x);
+            // krawędź nieskierowana zmienia oba kierunki
+            if(this->mGraph->kind()==GraphKind::Undirected && c.y!=c.x) changedEdges.emplace_back(c.x,c.y);
+        }
+    }
+
+    std::sort(changedEdges.begin(),changedEdges.end());
+    changedEdges.erase(std::unique(changedEdges.begin(),changedEdges.end()),changedEdges.end());
+
+    for(auto [y, x]: changedEdges)
+    {
+        std::vector<std::size_t>& inNeighbours = this->mInNeighbours[x];
+        const bool listed = std::find(inNeighbours.begin(),inNeighbours.end(),y)!=inNeighbours.end();
+        if(this->mGraph->edgeExist(y,x))
+        {
+            if(!listed) inNeighbours.push_back(y);
+        }
+        else if(listed)
+        {
+            mErase(inNeighbours,y);
+        }
+    }
+
+    // 1. wierzchołki, których krawędź w drzewie ścieżek zniknęła lub się wydłużyła, wraz z poddrzewami
+    std::vector<std::size_t> roots;
+    for(auto [y, x]: changedEdges)
+    {
+        if(this->mPrecursor[x]!=y)continue;
+        if(!this->mGraph->edgeExist(y,x) ||
+                this->mDistance[y]+this->mGetEdgeLength(this->mGraph->edgeLabel(y,x))>this->mDistance[x])
+        {
+            roots.push_back(x);
+        }
+    }
+
+    // odcięte wierzchołki są oznaczane nieskończoną odległością (wierzchołki drzewa mają skończoną)
+    std::vector<std::size_t> affected;
+    for(std::size_t root: roots)
+    {
+        if(this->mDistance[root]==MAX_DOUBLE_VALUE)continue;
+        const std::size_t first = affected.size();
+        affected.push_back(root);
+        this->mDistance[root] = MAX_DOUBLE_VALUE;
+        for(std::size_t i=first;i<affected.size();++i)
+        {
+            for(std::size_t child: this->mChildren[affected[i]])
+            {
+                if(this->mDistance[child]==MAX_DOUBLE_VALUE)continue;
+                this->mDistance[child] = MAX_DOUBLE_VALUE;
+                affected.push_back(child);
+            }
+        }
+    }
+    for(std::size_t v: affected)
+    {
+        this->mSetPrecursor(v,this->mNoPrecursor());
+    }
+
+    Queue q1;
+
+    // 2. odległości odciętych wierzchołków przez krawędzie z nienaruszonej części drzewa
+    for(std::size_t v: affected)
+    {
+        for(std::size_t u: this->mInNeighbours[v])
+        {
+            if(this->mDistance[u]!=MAX_DOUBLE_VALUE)
+            {
+                double newDistance = this->mDistance[u]+this->mGetEdgeLength(this->mGraph->edgeLabel(u,v));
+                if(newDistance<this->mDistance[v])
+                {
+                    this->mDistance[v] = newDistance;
+                    this->mSetPrecursor(v,u);
+                }
+            }
+        }
+        if(this->mDistance[v]!=MAX_DOUBLE_VALUE)q1.emplace(this->mDistance[v],v);
+    }
+
+    // 3. krawędzie nowe lub skrócone
+    for(auto [y, x]: changedEdges)
+    {
+        if(this->mDistance[y]!=MAX_DOUBLE_VALUE && this->mGraph->edgeExist(y,x))
+        {
+            double newDistance = this->mDistance[y]+this->mGetEdgeLength(this->mGraph->edgeLabel(y,x));
+            if(newDistance<this->mDistance[x])
+            {
+                this->mDistance[x] = newDistance;
+                this->mSetPrecursor(x,y);
+                q1.emplace(newDistance,x);
+            }
+        }
+    }
+
+    this->mLastUpdateSize = this->mPropagate(q1);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <utility>
 #include <vector>
 #include <iostream>
@@ -11,15 +15,59 @@
 #include <stack>
 #include <queue>
 
+#include "BitMatrix.hpp"
+#include "parallel.hpp"
+#include "tracing.hpp"
+
 // Uwaga! Kod powinien być odporny na błędy i każda z metod jeżeli zachodzi niebezpieczeństwo wywołania z niepoprawnymi parametrami powinna zgłaszac odpowiednie wyjątki!
 
-// klasa reprezentująca graf skierowany oparty na MACIERZY SĄSIEDZTWA
+// rodzaj grafu (wybierany przy tworzeniu)
+enum class GraphKind
+{
+    Directed,
+    // krawędź y-x jest jedna dla obu kierunków: edgeExist(y,x)==edgeExist(x,y), wspólna etykieta,
+    // przechowywana tylko w dolnym trójkącie macierzy (wiersz max(y,x), kolumna min(y,x))
+    Undirected
+};
+
+// klasa reprezentująca graf skierowany (lub nieskierowany, patrz "GraphKind") oparty na MACIERZY SĄSIEDZTWA
 // V - dane przechowywane przez wierzcholki
 // E - dane przechowywane przez krawedzie (etykiety)
 template <typename V, typename E>
 class Graph
 {
 public:
+    using vertex_type = V;
+    using edge_type = E;
+
+    // pojedyncza modyfikacja grafu zapisana w dzienniku zmian
+    // y, x - id wierzchołków krawędzi (EdgeChanged), lub id wierzchołka w "y" (Vertex*)
+    class Change
+    {
+    public:
+        enum Kind
+        {
+            VertexInserted,
+            VertexRemoved,
+            VertexChanged,
+            EdgeChanged,
+            Cleared
+        };
+        Kind kind;
+        std::uint64_t version;
+        std::size_t y;
+        std::size_t x;
+    };
+
+    // zmiana krawędzi y->x dla "applyEdgeBatch()": nowa etykieta krawędzi, lub std::nullopt - usunięcie krawędzi
+    class EdgeUpdate
+    {
+    public:
+        std::size_t y;
+        std::size_t x;
+        std::optional<E> label;
+    };
+
     // iterator po wierzchołkach (rosnąco po id wierzchołków)
     class VerticesIterator: public std::iterator
             <std::input_iterator_tag,V>
@@ -27,16 +75,16 @@ public:
         // ...
         friend class Graph;
         std::size_t index;
-        std::vector<V>* vecPtr;
+        Graph* graphPtr;
 
-        VerticesIterator(std::size_t index,std::vector<V>* vecPtr)
-            :index(index), vecPtr(vecPtr)
+        VerticesIterator(std::size_t index,Graph* graphPtr)
+            :index(index), graphPtr(graphPtr)
         {
         }
     public:
         bool operator==(const VerticesIterator &vi2) const
         {
-            return this->index==vi2.index&&this->vecPtr==vi2.vecPtr;
+            return this->index==vi2.index&&this->graphPtr==vi2.graphPtr;
         }
         bool operator!=(const VerticesIterator &vi2) const
         {
@@ -57,12 +105,13 @@ public:
 
         operator bool()const
         {
-            return this->index<this->vecPtr->size();
+            return this->index<this->graphPtr->nrOfVertices();
         }
 
+        // dostęp przez niestały iterator działa jak niestałe "vertexData()" (zmienia wersję grafu)
         V& operator*() const
         {
-            return (*this->vecPtr)[this->index];
+            return this->graphPtr->vertexData(this->index);
         }
         V* operator->() const
         {
@@ -76,24 +125,24 @@ public:
     };
 
     // iterator po istniejących krawędziach
+    // (w grafie nieskierowanym każda krawędź jest odwiedzana raz, z "v1id() >= v2id()")
     class EdgesIterator: public std::iterator
             <std::input_iterator_tag,E>
     {
         friend class Graph;
-        EdgesIterator(std::size_t y, std::size_t x,
-                      std::vector<std::vector<std::optional<E>>>*vecPtr)
-            :y(y),x(x), vecPtr(vecPtr)
+        EdgesIterator(std::size_t y, std::size_t x, Graph* graphPtr)
+            :y(y),x(x), graphPtr(graphPtr)
         {
 
         }
 
         void validate();
         std::size_t y,x;
-        std::vector<std::vector<std::optional<E>>>* vecPtr;
+        Graph* graphPtr;
     public:
         bool operator==(const EdgesIterator &ei) const
         {
-            return this->x==ei.x&&this->y==ei.y&&this->vecPtr==ei.vecPtr;
+            return this->x==ei.x&&this->y==ei.y&&this->graphPtr==ei.graphPtr;
         }
         bool operator!=(const EdgesIterator &ei) const
         {
@@ -107,9 +156,10 @@ public:
             return copy;
         }
         operator bool()const;
+        // dostęp przez niestały iterator działa jak niestałe "edgeLabel()" (zmienia wersję grafu)
         E& operator*() const
         {
-            return (*this->vecPtr)[y][x].value();
+            return this->graphPtr->edgeLabel(this->y,this->x);
         }
         E* operator->() const
         {
@@ -170,9 +220,10 @@ public:
             this->operator++();
             return copy;
         }
+        // jak niestałe "vertexData()" (zmienia wersję grafu)
         V& operator*() const
         {
-            return this->mGraph->vertexData(mVertexIndex);
+            return this->mGraph->vertexData(this->mVertexIndex);
         }
         V* operator->() const
         {
@@ -207,14 +258,74 @@ public:
 
 public:
     Graph()
-        :mEdgesNumber(0)
+        :Graph(std::pmr::get_default_resource())
+    {
+
+    }
+    // dane grafu (wierzchołki, wiersze macierzy i bloki kontrolne wspólnych wskaźników) są przydzielane z "resource",
+    // np. z std::pmr::monotonic_buffer_resource dla krótko żyjących grafów - zasób musi żyć dłużej niż graf i jego kopie
+    explicit Graph(std::pmr::memory_resource* resource)
+        :Graph(GraphKind::Directed,resource)
     {
 
     }
+    // graf nieskierowany zajmuje połowę pamięci grafu skierowanego z krawędziami w obie strony
+    explicit Graph(GraphKind kind, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        :mResource(resource),mUndirected(kind==GraphKind::Undirected),
+          mVertices(mMakeShared<VertexTable>()),
+          mInDegrees(mMakeShared<DegreeTable>()),
+          mEdges(mMakeShared<RowTable>()),
+          mEdgesNumber(0),mVersion(mNextVersion()),mIdsVersion(mVersion),
+          mJournalCapacity(0)
+    {
+        // wspólne puste tablice są tworzone zawczasu, żeby przeniesienie grafu nie przydzielało pamięci
+        mEmpty<VertexTable>();
+        mEmpty<DegreeTable>();
+        mEmpty<RowTable>();
+    }
+    // kopia współdzieli wierzchołki i wiersze macierzy ze źródłem (oraz jego zasób pamięci) - O(1)
+    // wspólne dane są kopiowane dopiero przy pierwszej modyfikacji (copy-on-write), osobno dla każdego wiersza
+    // referencje i wskaźniki do danych pobrane z niestałych "vertexData()", "edgeLabel()" lub iteratorów
+    // przed skopiowaniem grafu wskazują na wspólne dane - zapis przez nie zmieniłby też kopię,
+    // więc po skopiowaniu trzeba pobrać je ponownie
+    // kopiowanie grafu może się odbywać równolegle z czytaniem go w innych wątkach, ale nie z jego modyfikacją
     Graph(const Graph<V, E> &source) = default;
-    Graph(Graph<V, E> &&source) = default;
+    // graf źródłowy zostaje pusty (z nową wersją i pustym dziennikiem), przeniesienie nie przydziela pamięci
+    Graph(Graph<V, E> &&source) noexcept
+        :mResource(source.mResource),
+          mUndirected(source.mUndirected),
+          mVertices(std::move(source.mVertices)),
+          mInDegrees(std::move(source.mInDegrees)),
+          mEdges(std::move(source.mEdges)),
+          mEdgesNumber(source.mEdgesNumber),
+          mVersion(source.mVersion),
+          mIdsVersion(source.mIdsVersion),
+          mJournal(std::move(source.mJournal)),
+          mDataJournal(std::move(source.mDataJournal)),
+          mJournalCapacity(source.mJournalCapacity)
+    {
+        source.mMovedFrom();
+    }
     Graph& operator=(const Graph<V, E> &source) = default;
-    Graph& operator=(Graph<V, E> &&source) = default;
+    Graph& operator=(Graph<V, E> &&source) noexcept
+    {
+        if(this!=&source)
+        {
+            this->mResource = source.mResource;
+            this->mUndirected = source.mUndirected;
+            this->mVertices = std::move(source.mVertices);
+            this->mInDegrees = std::move(source.mInDegrees);
+            this->mEdges = std::move(source.mEdges);
+            this->mEdgesNumber = source.mEdgesNumber;
+            this->mVersion = source.mVersion;
+            this->mIdsVersion = source.mIdsVersion;
+            this->mJournal = std::move(source.mJournal);
+            this->mDataJournal = std::move(source.mDataJournal);
+            this->mJournalCapacity = source.mJournalCapacity;
+            source.mMovedFrom();
+        }
+        return *this;
+    }
     ~Graph() = default;
 
     // dodaje nowy wierzchołek z danymi przyjętymi w argumencie (wierzchołek powinien posiadać kopie danych) i zwraca "VerticesIterator" na nowo utworzony wierzchołek
@@ -244,17 +355,26 @@ public:
     EdgesIterator removeEdge(std::size_t y, std::size_t x);
     EdgesIterator removeEdge(VerticesIterator vi1,VerticesIterator vi2)
     {
-        this->mCheckEdge(vi1);
-        this->mCheckEdge(vi2);
+        this->mCheckIterator(vi1);
+        this->mCheckIterator(vi2);
         return this->removeEdge(vi1.index,vi2.index);
     }
 
     EdgesIterator removeEdge(EdgesIterator ei)
     {
         this->mCheckIterator(ei);
-        return this->removeEdge(ei.x,ei.y);
+        return this->removeEdge(ei.y,ei.x);
     }
 
+    // wykonuje zmiany krawędzi na "threadsNumber" wątkach (0 - wszystkie rdzenie), tak jak kolejne wywołania
+    // "insertEdge(y,x,label,true)" / "removeEdge(y,x)" - zmiany tej samej krawędzi w kolejności z "updates"
+    // zmiany są dzielone według wiersza "y": każdy wiersz zmienia jeden wątek, bez blokad,
+    // liczniki krawędzi i stopni wejściowych oraz dziennik zmian są uzgadniane na końcu
+    // jeśli któraś zmiana dotyczy nieistniejącego wierzchołka, wyjątek jest zgłaszany przed zmianą grafu
+    // graf nie może być w tym czasie używany przez inne wątki
+    // zwraca liczbę zmian, które zmieniły graf (usunięcie nieistniejącej krawędzi niczego nie zmienia)
+    std::size_t applyEdgeBatch(const std::vector<EdgeUpdate>& updates, std::size_t threadsNumber = 0);
+
     // zwraca true jeśli istnieje krawędź między wierzchołkami o podanych id, false w przeciwnym razie
     // O(1)
     bool edgeExist(std::size_t y, std::size_t x) const;
@@ -269,52 +389,144 @@ public:
     // O(1)
     std::size_t nrOfVertices() const
     {
-        return this->mVertices.size();
+        return this->mVertices->size();
+    }
+    GraphKind kind() const
+    {
+        return this->mUndirected ? GraphKind::Undirected : GraphKind::Directed;
     }
-    // zwraca ilość krawędzi w grafie
+    // zwraca liczbę krawędzi wychodzących z wierzchołka / wchodzących do wierzchołka o podanym id
+    // w grafie nieskierowanym oba stopnie są równe liczbie sąsiadów (pętla liczy się raz)
+    // O(1)
+    std::size_t outDegree(std::size_t vertex_id) const
+    {
+        this->mCheckVertex(vertex_id);
+        const Row* row = this->mRow(vertex_id);
+        const std::size_t degree = row!=nullptr ? row->degree : 0;
+        if(!this->mUndirected)return degree;
+        return degree+(*this->mInDegrees)[vertex_id]-(row!=nullptr && row->has(vertex_id) ? 1 : 0);
+    }
+    std::size_t inDegree(std::size_t vertex_id) const
+    {
+        if(this->mUndirected)return this->outDegree(vertex_id);
+        this->mCheckVertex(vertex_id);
+        return (*this->mInDegrees)[vertex_id];
+    }
+    // zwraca najmniejsze id >= "x" wierzchołka, do którego prowadzi krawędź z "y", lub "nrOfVertices()" jeśli takiego nie ma
+    // (przegląda słowa obecności krawędzi, a nie pojedyncze komórki macierzy)
+    // w grafie nieskierowanym sąsiedzi o id większym niż "y" leżą w kolumnie "y" - O(V) na cały wiersz
+    std::size_t nextNeighbor(std::size_t y, std::size_t x) const
+    {
+        this->mCheckVertex(y);
+        const Row* row = this->mRow(y);
+        if(row!=nullptr)
+        {
+            const std::size_t next = row->next(x);
+            if(next<row->size())return next;
+        }
+        if(this->mUndirected)
+        {
+            for(x=std::max(x,y+1);x<this->nrOfVertices();++x)
+            {
+                row = this->mRow(x);
+                if(row!=nullptr && row->has(y))return x;
+            }
+        }
+        return this->nrOfVertices();
+    }
+    // zwraca ilość krawędzi w grafie (w grafie nieskierowanym każda krawędź liczy się raz)
     // O(1)
     std::size_t nrOfEdges() const
     {
         return this->mEdgesNumber;
     }
+    // zwraca zasób pamięci, z którego są przydzielane dane grafu
+    std::pmr::memory_resource* memoryResource() const
+    {
+        return this->mResource;
+    }
+    // zwraca wersję grafu - zmienia się przy każdej modyfikacji wierzchołków lub krawędzi
+    // (również przy dostępie do niestałych "vertexData()" i "edgeLabel()" oraz przez iteratory)
+    // wersje są unikalne dla wszystkich grafów danego typu - równe wersje oznaczają tę samą zawartość
+    // O(1)
+    std::uint64_t version() const
+    {
+        return this->mVersion;
+    }
+    // zwraca wersję numeracji wierzchołków - zmienia się tylko wtedy, gdy id istniejących wierzchołków mogły się zmienić
+    // ("removeVertex()", "clear()", "permuteVertices()")
+    // O(1)
+    std::uint64_t idsVersion() const
+    {
+        return this->mIdsVersion;
+    }
+    // włącza dziennik ostatnich "capacity" zmian (0 wyłącza dziennik)
+    // zmiany danych wierzchołków (VertexChanged) mają osobny dziennik o tej samej pojemności,
+    // więc nie wypierają zmian struktury grafu
+    void enableChangeJournal(std::size_t capacity)
+    {
+        if(this->mJournalCapacity==0)
+        {
+            this->mJournal.clear(this->mVersion);
+            this->mDataJournal.clear(this->mVersion);
+        }
+        this->mJournalCapacity = capacity;
+        this->mJournal.setCapacity(capacity);
+        this->mDataJournal.setCapacity(capacity);
+    }
+    std::size_t changeJournalCapacity() const
+    {
+        return this->mJournalCapacity;
+    }
+    // zwraca zmiany wykonane po podanej wersji grafu (najstarsze pierwsze),
+    // lub std::nullopt jeśli dziennik ich już nie zawiera (wyłączony, przepełniony albo wersja pochodzi z innego grafu)
+    std::optional<std::vector<Change>> changesSince(std::uint64_t version) const;
+    // jak "changesSince()", ale bez zmian danych wierzchołków (VertexChanged) - wystarcza dla algorytmów,
+    // które zależą tylko od krawędzi i numeracji wierzchołków; wersja musi pochodzić z tego grafu (lub jego kopii)
+    std::optional<std::vector<Change>> structureChangesSince(std::uint64_t version) const;
     // drukuje macierz sąsiedztwa na konsoli (debug)
     void printNeighborhoodMatrix() const;
     // zwraca "VerticesIterator" do wierzchołka o podanym id, lub to samo co "endVertices()" w przypadku braku wierzchołka o podanym id
     VerticesIterator vertex(std::size_t vertex_id)
     {
-        return vertex_id < this->mVertices.size()
-                ? VerticesIterator(vertex_id,&this->mVertices)
+        return vertex_id < this->nrOfVertices()
+                ? VerticesIterator(vertex_id,this)
                 : this->endVertices();
     }
     // zwraca referencję do danych wierzchołka o podanym id
     const V& vertexData(std::size_t vertex_id) const
     {
         this->mCheckVertex(vertex_id);
-        return this->mVertices[vertex_id];
+        return (*this->mVertices)[vertex_id];
     }
     // zwraca referencję do danych wierzchołka o podanym id
     V& vertexData(std::size_t vertex_id)
     {
         this->mCheckVertex(vertex_id);
-        return this->mVertices[vertex_id];
+        this->mModified(Change::VertexChanged,vertex_id);
+        return this->mOwnVertices()[vertex_id];
     }
     // zwraca "EdgesIterator" do krawędzi pomiędzy wierzchołkami o podanych id, lub to samo co "endEdges()" w przypadku braku krawędzi między wierzchołkami o podanych id
     EdgesIterator edge(std::size_t y, std::size_t x)
     {
+        this->mNormalize(y,x);
         return this->edgeExist(y,x)
-                ?EdgesIterator(y,x,&this->mEdges):this->endEdges();
+                ?EdgesIterator(y,x,this):this->endEdges();
     }
     // zwraca referencję do danych (etykiety) krawędzi pomiędzy wierzchołkami o podanych id
     const E& edgeLabel(std::size_t y, std::size_t x) const
     {
         this->mCheckEdge(y,x);
-        return this->mEdges[y][x].value();
+        this->mNormalize(y,x);
+        return this->mRow(y)->cells[x].value();
     }
     // zwraca referencję do danych (etykiety) krawędzi pomiędzy wierzchołkami o podanych id
     E& edgeLabel(std::size_t y, std::size_t x)
     {
         this->mCheckEdge(y,x);
-        return this->mEdges[y][x].value();
+        this->mNormalize(y,x);
+        this->mModified(Change::EdgeChanged,y,x);
+        return this->mOwnRow(y).cells[x].value();
     }
 
     VerticesIterator begin() { return beginVertices(); }
@@ -322,24 +534,24 @@ public:
     // zwraca "VerticesIterator" na pierwszy wierzchołek (o najmniejszym id)
     VerticesIterator beginVertices()
     {
-        return VerticesIterator(0, &this->mVertices);
+        return VerticesIterator(0, this);
     }
     // zwraca "VerticesIterator" "za ostatni" wierzchołek
     VerticesIterator endVertices()
     {
-        return VerticesIterator(this->mVertices.size(),&this->mVertices);
+        return VerticesIterator(this->nrOfVertices(),this);
     }
     // zwraca "EdgesIterator" na pierwszą krawędz
     EdgesIterator beginEdges()
     {
-        EdgesIterator it(0,0,&this->mEdges);
+        EdgesIterator it(0,0,this);
         it.validate();
         return it;
     }
     // zwraca "EdgesIterator" "za ostatnią" krawędz
     EdgesIterator endEdges()
     {
-        return EdgesIterator(this->mVertices.size(),0,&this->mEdges);
+        return EdgesIterator(this->nrOfVertices(),0,this);
     }
 
     FSIterator<false> beginDFS(std::size_t vertexIndex)
@@ -363,10 +575,316 @@ public:
     }
 
     void clear();
+    // przenumerowuje wierzchołki: wierzchołek o id "y" dostaje id "newIds[y]" razem z danymi i krawędziami
+    // dziennik zmian jest czyszczony ("changesSince()" dla starszych wersji zwraca std::nullopt),
+    // więc indeksy oparte na dzienniku przebudowują się przy następnym zapytaniu, a "DynamicShortestPaths"
+    // (którego źródło zmienia id) zgłasza wyjątek
+    // O(V^2)
+    void permuteVertices(const std::vector<std::size_t>& newIds);
 private:
-    std::vector<V> mVertices;
-    std::vector<std::vector<std::optional<E>>> mEdges;
+    // wiersz macierzy sąsiedztwa - może być krótszy niż liczba wierzchołków (brakujące komórki są puste),
+    // pusty wiersz to nullptr
+    // bit "x" słowa obecności jest ustawiony wtedy i tylko wtedy, gdy komórka "x" nie jest pusta,
+    // bity za ostatnią komórką są zerami
+    class Row
+    {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        explicit Row(const allocator_type& alloc)
+            :cells(alloc),presence(alloc),degree(0)
+        {
+
+        }
+        Row(std::size_t width, const allocator_type& alloc)
+            :cells(width,alloc),presence(mWords(width),0,alloc),degree(0)
+        {
+
+        }
+        // kopia o długości co najmniej "width"
+        Row(const Row& source, std::size_t width, const allocator_type& alloc)
+            :cells(alloc),presence(alloc),degree(source.degree)
+        {
+            width = std::max(width,source.cells.size());
+            this->cells.reserve(width);
+            this->cells.assign(source.cells.begin(),source.cells.end());
+            this->cells.resize(width);
+            this->presence.reserve(mWords(width));
+            this->presence.assign(source.presence.begin(),source.presence.end());
+            this->presence.resize(mWords(width),0);
+        }
+
+        std::pmr::vector<std::optional<E>> cells;
+        std::pmr::vector<std::uint64_t> presence;
+        // liczba niepustych komórek
+        std::size_t degree;
+
+        std::size_t size() const
+        {
+            return this->cells.size();
+        }
+        bool has(std::size_t x) const
+        {
+            return x<this->cells.size() && ((this->presence[x/BitMatrix::WORD_BITS]>>(x%BitMatrix::WORD_BITS))&1u);
+        }
+        void resize(std::size_t width)
+        {
+            this->cells.resize(width);
+            this->presence.resize(mWords(width),0);
+        }
+        void set(std::size_t x, const E& label)
+        {
+            if(!this->cells[x].has_value())
+            {
+                this->presence[x/BitMatrix::WORD_BITS] |= std::uint64_t(1)<<(x%BitMatrix::WORD_BITS);
+                ++this->degree;
+            }
+            this->cells[x] = label;
+        }
+        void reset(std::size_t x)
+        {
+            if(this->cells[x].has_value())
+            {
+                this->presence[x/BitMatrix::WORD_BITS] &= ~(std::uint64_t(1)<<(x%BitMatrix::WORD_BITS));
+                --this->degree;
+            }
+            this->cells[x].reset();
+        }
+        // usuwa komórkę "x" (dalsze komórki przesuwają się o jedną w lewo), zwraca true jeśli nie była pusta
+        bool eraseColumn(std::size_t x)
+        {
+            const bool removed = this->cells[x].has_value();
+            this->cells.erase(this->cells.begin()+x);
+
+            const std::size_t w = x/BitMatrix::WORD_BITS;
+            const std::uint64_t low = (std::uint64_t(1)<<(x%BitMatrix::WORD_BITS))-1;
+            this->presence[w] = (this->presence[w]&low)|((this->presence[w]>>1)&~low);
+            for(std::size_t i=w+1;i<this->presence.size();++i)
+            {
+                this->presence[i-1] |= (this->presence[i]&1u)<<(BitMatrix::WORD_BITS-1);
+                this->presence[i] >>= 1;
+            }
+            this->presence.resize(mWords(this->cells.size()));
+            if(removed)--this->degree;
+            return removed;
+        }
+        // najmniejsze "x2" >= "x" z niepustą komórką, lub "size()"
+        std::size_t next(std::size_t x) const
+        {
+            std::size_t w = x/BitMatrix::WORD_BITS;
+            if(w>=this->presence.size())return this->size();
+            std::uint64_t bits = this->presence[w]&(~std::uint64_t(0)<<(x%BitMatrix::WORD_BITS));
+            while(bits==0)
+            {
+                if(++w==this->presence.size())return this->size();
+                bits = this->presence[w];
+            }
+            return w*BitMatrix::WORD_BITS+bitScanForward(bits);
+        }
+    private:
+        static std::size_t mWords(std::size_t width)
+        {
+            return (width+BitMatrix::WORD_BITS-1)/BitMatrix::WORD_BITS;
+        }
+    };
+    using RowTable = std::pmr::vector<std::shared_ptr<Row>>;
+    using VertexTable = std::pmr::vector<V>;
+    using DegreeTable = std::pmr::vector<std::size_t>;
+
+    std::pmr::memory_resource* mResource;
+    bool mUndirected;
+    std::shared_ptr<VertexTable> mVertices;
+    // liczba krawędzi wchodzących do każdego wierzchołka (wychodzące liczy "Row::degree")
+    // w grafie nieskierowanym: liczba krawędzi zapisanych w kolumnie wierzchołka
+    std::shared_ptr<DegreeTable> mInDegrees;
+    std::shared_ptr<RowTable> mEdges;
     std::size_t mEdgesNumber;
+    // bufor cykliczny ostatnich zmian (wersje rosną od najstarszej zmiany)
+    // zawija się dopiero po zapełnieniu - przy mniejszej liczbie zmian zmiany leżą w kolejności od początku
+    class Journal
+    {
+    public:
+        // wersja grafu sprzed najstarszej zmiany w dzienniku
+        std::uint64_t base() const
+        {
+            return this->mBase;
+        }
+        std::size_t size() const
+        {
+            return this->mEntries.size();
+        }
+        // "i"-ta zmiana od najstarszej
+        const Change& operator[](std::size_t i) const
+        {
+            return this->mEntries[(this->mHead+i)%this->mEntries.size()];
+        }
+        void clear(std::uint64_t base) noexcept
+        {
+            this->mEntries.clear();
+            this->mHead = 0;
+            this->mBase = base;
+        }
+        // dodaje zmianę, w pełnym dzienniku zastępując najstarszą
+        void push(const Change& change, std::size_t capacity)
+        {
+            if(this->mEntries.size()<capacity)
+            {
+                this->mEntries.push_back(change);
+                return;
+            }
+            Change& oldest = this->mEntries[this->mHead];
+            this->mBase = oldest.version;
+            oldest = change;
+            this->mHead = (this->mHead+1)%this->mEntries.size();
+        }
+        // zostawia najnowsze "capacity" zmian
+        void setCapacity(std::size_t capacity)
+        {
+            std::rotate(this->mEntries.begin(),this->mEntries.begin()+this->mHead,this->mEntries.end());
+            this->mHead = 0;
+            if(this->mEntries.size()>capacity)
+            {
+                const std::size_t removed = this->mEntries.size()-capacity;
+                this->mBase = this->mEntries[removed-1].version;
+                this->mEntries.erase(this->mEntries.begin(),this->mEntries.begin()+removed);
+            }
+        }
+        // indeks pierwszej zmiany wykonanej po wersji "version" - O(log n)
+        std::size_t after(std::uint64_t version) const
+        {
+            std::size_t first = 0, last = this->size();
+            while(first<last)
+            {
+                const std::size_t middle = first+(last-first)/2;
+                if((*this)[middle].version<=version) first = middle+1;
+                else last = middle;
+            }
+            return first;
+        }
+        // sprawdza, czy wersja jest początkiem dziennika albo jest w nim zapisana
+        bool contains(std::uint64_t version) const
+        {
+            if(version==this->mBase) return true;
+            const std::size_t i = this->after(version);
+            return i>0 && (*this)[i-1].version==version;
+        }
+    private:
+        std::vector<Change> mEntries;
+        std::size_t mHead = 0;
+        std::uint64_t mBase = 0;
+    };
+
+    std::uint64_t mVersion;
+    std::uint64_t mIdsVersion;
+    // dziennik zmian struktury (wierzchołki, krawędzie) i osobny dziennik zmian danych wierzchołków
+    Journal mJournal;
+    Journal mDataJournal;
+    std::size_t mJournalCapacity;
+
+    static std::uint64_t mNextVersion()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return ++counter;
+    }
+    void mModified(typename Change::Kind kind, std::size_t y = 0, std::size_t x = 0)
+    {
+        this->mVersion = mNextVersion();
+        if(kind==Change::VertexRemoved || kind==Change::Cleared) this->mIdsVersion = this->mVersion;
+        if(this->mJournalCapacity>0)
+        {
+            Journal& journal = kind==Change::VertexChanged?this->mDataJournal:this->mJournal;
+            journal.push(Change{kind,this->mVersion,y,x},this->mJournalCapacity);
+        }
+    }
+    // wspólne puste tablice grafów, z których przeniesiono dane
+    template<typename T>
+    static const std::shared_ptr<T>& mEmpty()
+    {
+        static const std::shared_ptr<T> empty =
+                std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(std::pmr::new_delete_resource()));
+        return empty;
+    }
+    // zostawia pusty graf po przeniesieniu danych (bez przydzielania pamięci)
+    void mMovedFrom() noexcept
+    {
+        this->mVertices = mEmpty<VertexTable>();
+        this->mInDegrees = mEmpty<DegreeTable>();
+        this->mEdges = mEmpty<RowTable>();
+        this->mEdgesNumber = 0;
+        this->mVersion = mNextVersion();
+        this->mIdsVersion = this->mVersion;
+        this->mJournal.clear(this->mVersion);
+        this->mDataJournal.clear(this->mVersion);
+    }
+
+    // tworzy obiekt (razem z blokiem kontrolnym) w zasobie grafu, kontenery dostają zasób jako alokator
+    template<typename T, typename... Args>
+    std::shared_ptr<T> mMakeShared(Args&&... args) const
+    {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(this->mResource),std::forward<Args>(args)...);
+    }
+    // w grafie nieskierowanym krawędź y-x jest zapisana w wierszu max(y,x), kolumnie min(y,x)
+    void mNormalize(std::size_t& y, std::size_t& x) const
+    {
+        if(this->mUndirected && y<x)std::swap(y,x);
+    }
+    // zwraca wiersz "y" (lub nullptr dla pustego wiersza) bez kopiowania
+    const Row* mRow(std::size_t y) const
+    {
+        return (*this->mEdges)[y].get();
+    }
+    // sprawdza, czy dane są współdzielone z innymi grafami (use_count()==1 oznacza wyłączną własność -
+    // inne grafy mogą ją tylko zwolnić)
+    // use_count() jest odczytem bez synchronizacji, więc przy wyłącznej własności bariera acquire
+    // synchronizuje się ze zwolnieniem ostatniej kopii (release) w innym wątku - jej odczyty wspólnych danych
+    // poprzedzają wtedy zapis w tym grafie
+    template<typename T>
+    static bool mShared(const std::shared_ptr<T>& data)
+    {
+        if(data.use_count()>1) return true;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return false;
+    }
+    // dane współdzielone z innymi grafami są kopiowane przed pierwszą zmianą
+    VertexTable& mOwnVertices()
+    {
+        if(mShared(this->mVertices))
+        {
+            this->mVertices = this->mMakeShared<VertexTable>(*this->mVertices);
+        }
+        return *this->mVertices;
+    }
+    DegreeTable& mOwnInDegrees()
+    {
+        if(mShared(this->mInDegrees))
+        {
+            this->mInDegrees = this->mMakeShared<DegreeTable>(*this->mInDegrees);
+        }
+        return *this->mInDegrees;
+    }
+    RowTable& mOwnRows()
+    {
+        if(mShared(this->mEdges))
+        {
+            this->mEdges = this->mMakeShared<RowTable>(*this->mEdges);
+        }
+        return *this->mEdges;
+    }
+    // zwraca wiersz "y" do zapisu, o długości co najmniej "width"
+    Row& mOwnRow(std::size_t y, std::size_t width = 0)
+    {
+        std::shared_ptr<Row>& row = this->mOwnRows()[y];
+        if(!row)
+        {
+            row = this->mMakeShared<Row>(width);
+        }
+        else if(mShared(row))
+        {
+            row = this->mMakeShared<Row>(*row,width);
+        }
+        if(row->size()<width)row->resize(width);
+        return *row;
+    }
 
     void mCheckVertex(size_t vertex_id)const;
     void mCheckEdge(size_t y, size_t x)const;
@@ -377,107 +895,202 @@ private:
 template<typename V, typename E>
 typename Graph<V,E>::EdgesIterator& Graph<V,E>::EdgesIterator::operator++()
 {
-    std::size_t verticesNumber = this->vecPtr->size();
-    do
-    {
-        ++x;
-        if(x>=verticesNumber)
-        {
-            x=0;
-            ++y;
-        }
-    }while(y<verticesNumber && !(*this->vecPtr)[y][x].has_value());
-
+    ++x;
+    this->validate();
     return *this;
 }
 
 template<typename V, typename E>
 void Graph<V,E>::EdgesIterator::validate()
 {
-    std::size_t verticesNumber = this->vecPtr->size();
-    while(y<verticesNumber && !(*this->vecPtr)[y][x].has_value())
+    std::size_t verticesNumber = this->graphPtr->nrOfVertices();
+    while(y<verticesNumber)
     {
-        ++x;
-        if(x>=verticesNumber)
+        // puste wiersze są pomijane w całości, a niepuste przeglądane po słowach obecności
+        const Row* row = this->graphPtr->mRow(y);
+        if(row!=nullptr && row->degree>0)
         {
-            x=0;
-            ++y;
+            x = row->next(x);
+            if(x<row->size())return;
         }
+        x=0;
+        ++y;
     }
 }
 
 template<typename V, typename E>
 Graph<V,E>::EdgesIterator::operator bool()const
 {
-    std::size_t verticesNumber = this->vecPtr->size();
-
-    if(this->x<verticesNumber&&this->y<verticesNumber)
-    {
-        return (*this->vecPtr)[y][x].has_value();
-    }
-    return false;
+    return this->graphPtr->edgeExist(this->y,this->x);
 }
 
 template<typename V, typename E>
 typename Graph<V,E>::VerticesIterator Graph<V,E>::insertVertex(const V&vertexData)
 {
-    size_t index = this->mVertices.size();
-    this->mVertices.push_back(vertexData);
-
-    size_t s1 = index+1;
-    this->mEdges.resize(s1);
-    for(std::vector<std::optional<E>>& v1: this->mEdges)
-    {
-        v1.resize(s1);
-    }
-    return VerticesIterator(s1,&this->mVertices);
+    GRAPH_TRACE_SPAN(span,"mutation","Graph::insertVertex");
+    size_t index = this->nrOfVertices();
+    this->mOwnVertices().push_back(vertexData);
+    this->mOwnInDegrees().push_back(0);
+    // nowy wiersz jest pusty, a pozostałe wiersze nie muszą być wydłużane
+    this->mOwnRows().push_back(nullptr);
+    this->mModified(Change::VertexInserted,index);
+    return VerticesIterator(index,this);
 }
 
 template<typename V, typename E>
 std::pair<typename Graph<V,E>::EdgesIterator, bool> Graph<V,E>::
 insertEdge(std::size_t y, std::size_t x, const E &label,bool replace)
 {
-    std::size_t verticesNumber = this->mVertices.size();
+    GRAPH_TRACE_SPAN(span,"mutation","Graph::insertEdge");
+    std::size_t verticesNumber = this->nrOfVertices();
 
     if(y<verticesNumber&&x<verticesNumber)
     {
-        if(this->mEdges[y][x].has_value())
+        this->mNormalize(y,x);
+        if(this->edgeExist(y,x))
         {
             if(!replace)return std::make_pair(
-                        EdgesIterator(y,x,&this->mEdges),false);
+                        EdgesIterator(y,x,this),false);
         }
         else
         {
             ++this->mEdgesNumber;
+            ++this->mOwnInDegrees()[x];
         }
 
-        this->mEdges[y][x] = label;
-        return std::make_pair(EdgesIterator(y,x,&this->mEdges),true);
+        this->mOwnRow(y,x+1).set(x,label);
+        this->mModified(Change::EdgeChanged,y,x);
+        return std::make_pair(EdgesIterator(y,x,this),true);
     }
 
     return std::make_pair(this->endEdges(),false);
 }
 
 template<typename V,typename E>
-typename Graph<V,E>::VerticesIterator Graph<V,E>::removeVertex(std::size_t vertex_id)
+std::size_t Graph<V,E>::applyEdgeBatch(const std::vector<EdgeUpdate>& updates, std::size_t threadsNumber)
 {
-    if(vertex_id < this->mVertices.size())
+    GRAPH_TRACE_SPAN(span,"mutation","Graph::applyEdgeBatch");
+    const std::size_t verticesNumber = this->nrOfVertices();
+    // komórki macierzy zmienianych krawędzi (wiersz, kolumna)
+    std::vector<std::pair<std::size_t, std::size_t>> cells(updates.size());
+    for(std::size_t i=0;i<updates.size();++i)
     {
-        this->mVertices.erase(this->mVertices.begin()+vertex_id);
+        this->mCheckVertex(updates[i].y);
+        this->mCheckVertex(updates[i].x);
+        cells[i] = std::make_pair(updates[i].y,updates[i].x);
+        this->mNormalize(cells[i].first,cells[i].second);
+    }
+
+    // zmiany pogrupowane według wiersza (sortowanie przez zliczanie, stabilne)
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    for(const auto& cell: cells) ++offsets[cell.first+1];
+    for(std::size_t v=0;v<verticesNumber;++v) offsets[v+1] += offsets[v];
+    std::vector<std::size_t> order(updates.size());
+    {
+        std::vector<std::size_t> fill(offsets.begin(),offsets.end()-1);
+        for(std::size_t i=0;i<updates.size();++i) order[fill[cells[i].first]++] = i;
+    }
+
+    // wiersze są kopiowane i poszerzane przed zmianami równoległymi -
+    // zasób pamięci grafu nie musi być bezpieczny wątkowo
+    std::vector<std::size_t> rows;
+    this->mOwnRows();
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        if(offsets[y]==offsets[y+1])continue;
+        std::size_t width = 0;
+        for(std::size_t i=offsets[y];i<offsets[y+1];++i)
+        {
+            if(updates[order[i]].label.has_value()) width = std::max(width,cells[order[i]].second+1);
+        }
+        if(width>0 || this->mRow(y)!=nullptr)
+        {
+            this->mOwnRow(y,width);
+            rows.push_back(y);
+        }
+    }
+
+    // skutek każdej zmiany: 0 - brak, 1 - nowa krawędź, 2 - zastąpiona etykieta, 3 - usunięta krawędź
+    std::vector<unsigned char> effects(updates.size(),0);
+    parallelFor(0,rows.size(),[&](std::size_t r)
+    {
+        const std::size_t y = rows[r];
+        Row& row = *(*this->mEdges)[y];
+        for(std::size_t i=offsets[y];i<offsets[y+1];++i)
+        {
+            const std::size_t x = cells[order[i]].second;
+            const std::optional<E>& label = updates[order[i]].label;
+            if(label.has_value())
+            {
+                effects[order[i]] = row.has(x) ? 2 : 1;
+                row.set(x,*label);
+            }
+            else if(row.has(x))
+            {
+                effects[order[i]] = 3;
+                row.reset(x);
+            }
+        }
+    },threadsNumber,16);
+
+    std::size_t changes = 0;
+    DegreeTable& inDegrees = this->mOwnInDegrees();
+    for(std::size_t i=0;i<updates.size();++i)
+    {
+        if(effects[i]==0)continue;
+        if(effects[i]==1)
+        {
+            ++this->mEdgesNumber;
+            ++inDegrees[cells[i].second];
+        }
+        else if(effects[i]==3)
+        {
+            --this->mEdgesNumber;
+            --inDegrees[cells[i].second];
+        }
+        ++changes;
+        if(this->mJournalCapacity>0) this->mModified(Change::EdgeChanged,cells[i].first,cells[i].second);
+    }
+    // bez dziennika wystarczy jedna nowa wersja
+    if(changes>0 && this->mJournalCapacity==0) this->mModified(Change::EdgeChanged);
+    return changes;
+}
 
-        for(std::optional<E>& op: this->mEdges[vertex_id])
+template<typename V,typename E>
+typename Graph<V,E>::VerticesIterator Graph<V,E>::removeVertex(std::size_t vertex_id)
+{
+    if(vertex_id < this->nrOfVertices())
+    {
+        GRAPH_TRACE_SPAN(span,"mutation","Graph::removeVertex");
+        VertexTable& vertices = this->mOwnVertices();
+        vertices.erase(vertices.begin()+vertex_id);
+        this->mModified(Change::VertexRemoved,vertex_id);
+
+        RowTable& rows = this->mOwnRows();
+        DegreeTable& inDegrees = this->mOwnInDegrees();
+        if(rows[vertex_id])
         {
-            if(op.has_value()) --this->mEdgesNumber;
+            const Row& removed = *rows[vertex_id];
+            this->mEdgesNumber -= removed.degree;
+            for(std::size_t x=removed.next(0);x<removed.size();x=removed.next(x+1))
+            {
+                --inDegrees[x];
+            }
         }
-        this->mEdges.erase(this->mEdges.begin()+vertex_id);
+        rows.erase(rows.begin()+vertex_id);
+        // krawędzie do usuwanego wierzchołka są liczone tylko w jego stopniu wejściowym, usuwanym razem z nim
+        inDegrees.erase(inDegrees.begin()+vertex_id);
 
-        for(std::vector<std::optional<E>>& v1:this->mEdges)
+        // kopiowane są tylko wiersze sięgające usuwanej kolumny
+        for(std::size_t y=0;y<rows.size();++y)
         {
-            if(v1[vertex_id].has_value()) --this->mEdgesNumber;
-            v1.erase(v1.begin()+vertex_id);
+            if(rows[y] && rows[y]->size()>vertex_id)
+            {
+                if(this->mOwnRow(y).eraseColumn(vertex_id)) --this->mEdgesNumber;
+            }
         }
 
-        return VerticesIterator(vertex_id,&this->mVertices);
+        return VerticesIterator(vertex_id,this);
     }
     return this->endVertices();
 }
@@ -488,10 +1101,13 @@ typename Graph<V,E>::EdgesIterator Graph<V,E>::removeEdge(std::size_t y, std::si
 {
     if(this->edgeExist(y,x))
     {
+        this->mNormalize(y,x);
         --this->mEdgesNumber;
-        this->mEdges[y][x].reset();
+        --this->mOwnInDegrees()[x];
+        this->mOwnRow(y).reset(x);
+        this->mModified(Change::EdgeChanged,y,x);
 
-        EdgesIterator iter(y,x,&this->mEdges);
+        EdgesIterator iter(y,x,this);
         iter.validate();
         return iter;
     }
@@ -502,9 +1118,11 @@ typename Graph<V,E>::EdgesIterator Graph<V,E>::removeEdge(std::size_t y, std::si
 template<typename V,typename E>
 bool Graph<V,E>::edgeExist(std::size_t y, std::size_t x)const
 {
-    if(y<this->mVertices.size()&&x<this->mVertices.size())
+    if(y<this->nrOfVertices()&&x<this->nrOfVertices())
     {
-        return this->mEdges[y][x].has_value();
+        this->mNormalize(y,x);
+        const Row* row = this->mRow(y);
+        return row!=nullptr && row->has(x);
     }
     return false;
 }
@@ -523,15 +1141,144 @@ void Graph<V,E>::mCheckEdge(size_t y, size_t x)const
 template<typename V,typename E>
 void Graph<V,E>::clear()
 {
-    this->mEdges.clear();
-    this->mVertices.clear();
+    // nie zmienia grafów współdzielących dane
+    this->mEdges = this->mMakeShared<RowTable>();
+    this->mVertices = this->mMakeShared<VertexTable>();
+    this->mInDegrees = this->mMakeShared<DegreeTable>();
     this->mEdgesNumber=0;
+    this->mModified(Change::Cleared);
+}
+
+template<typename V,typename E>
+void Graph<V,E>::permuteVertices(const std::vector<std::size_t>& newIds)
+{
+    GRAPH_TRACE_SPAN(span,"mutation","Graph::permuteVertices");
+    const std::size_t verticesNumber = this->nrOfVertices();
+    if(newIds.size()!=verticesNumber)
+    {
+        throw std::runtime_error("[Graph] Incorrect permutation size: "+std::to_string(newIds.size()));
+    }
+    std::vector<std::size_t> oldIds(verticesNumber,verticesNumber);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        if(newIds[y]>=verticesNumber||oldIds[newIds[y]]!=verticesNumber)
+        {
+            throw std::runtime_error("[Graph] Incorrect permutation: "+std::to_string(newIds[y]));
+        }
+        oldIds[newIds[y]] = y;
+    }
+
+    // nowe dane są budowane obok starych - grafy współdzielące dane nie są zmieniane
+    auto vertices = this->mMakeShared<VertexTable>();
+    vertices->reserve(verticesNumber);
+    for(std::size_t v: oldIds) vertices->push_back((*this->mVertices)[v]);
+
+    // w grafie nieskierowanym krawędź może przejść do innego wiersza (zmienia się, który koniec ma większe id),
+    // więc najpierw liczone są długości nowych wierszy
+    std::vector<std::size_t> widths(verticesNumber,0);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        const Row* row = this->mRow(y);
+        if(row==nullptr||row->degree==0)continue;
+        for(std::size_t x=row->next(0);x<row->size();x=row->next(x+1))
+        {
+            std::size_t newY = newIds[y], newX = newIds[x];
+            this->mNormalize(newY,newX);
+            widths[newY] = std::max(widths[newY],newX+1);
+        }
+    }
+
+    auto inDegrees = this->mMakeShared<DegreeTable>(verticesNumber);
+    auto rows = this->mMakeShared<RowTable>(verticesNumber);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        if(widths[y]>0) (*rows)[y] = this->mMakeShared<Row>(widths[y]);
+    }
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        const Row* row = this->mRow(y);
+        if(row==nullptr||row->degree==0)continue;
+        for(std::size_t x=row->next(0);x<row->size();x=row->next(x+1))
+        {
+            std::size_t newY = newIds[y], newX = newIds[x];
+            this->mNormalize(newY,newX);
+            (*rows)[newY]->set(newX,row->cells[x].value());
+            ++(*inDegrees)[newX];
+        }
+    }
+
+    this->mVertices = std::move(vertices);
+    this->mInDegrees = std::move(inDegrees);
+    this->mEdges = std::move(rows);
+    this->mVersion = mNextVersion();
+    this->mIdsVersion = this->mVersion;
+    this->mJournal.clear(this->mVersion);
+    this->mDataJournal.clear(this->mVersion);
+}
+
+template<typename V,typename E>
+std::optional<std::vector<typename Graph<V,E>::Change>> Graph<V,E>::changesSince(std::uint64_t version) const
+{
+    if(version==this->mVersion)
+    {
+        return std::vector<Change>();
+    }
+    if(this->mJournalCapacity==0 || version<this->mJournal.base() || version<this->mDataJournal.base())
+    {
+        return std::nullopt;
+    }
+
+    // wersja musi być zapisana w jednym z dzienników (albo być ich początkiem)
+    if(!this->mJournal.contains(version) && !this->mDataJournal.contains(version))
+    {
+        return std::nullopt;
+    }
+
+    // scalenie obu dzienników po wersjach
+    std::size_t i = this->mJournal.after(version);
+    std::size_t j = this->mDataJournal.after(version);
+    std::vector<Change> result;
+    result.reserve(this->mJournal.size()-i+this->mDataJournal.size()-j);
+    while(i<this->mJournal.size() || j<this->mDataJournal.size())
+    {
+        if(j==this->mDataJournal.size() ||
+                (i<this->mJournal.size() && this->mJournal[i].version<this->mDataJournal[j].version))
+        {
+            result.push_back(this->mJournal[i++]);
+        }
+        else
+        {
+            result.push_back(this->mDataJournal[j++]);
+        }
+    }
+    return result;
+}
+
+template<typename V,typename E>
+std::optional<std::vector<typename Graph<V,E>::Change>> Graph<V,E>::structureChangesSince(std::uint64_t version) const
+{
+    if(version==this->mVersion)
+    {
+        return std::vector<Change>();
+    }
+    // zmiany danych wierzchołków mogły już wypaść ze swojego dziennika, więc wystarcza zakres wersji
+    if(this->mJournalCapacity==0 || version<this->mJournal.base() || version>this->mVersion)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<Change> result;
+    for(std::size_t i=this->mJournal.after(version);i<this->mJournal.size();++i)
+    {
+        result.push_back(this->mJournal[i]);
+    }
+    return result;
 }
 
 template<typename V,typename E>
 void Graph<V,E>::mCheckVertex(size_t vertex_id)const
 {
-    if(vertex_id>=this->mVertices.size())
+    if(vertex_id>=this->nrOfVertices())
     {
         std::ostringstream os;
         os<<"[Graph] Vertex["<<vertex_id<<"] does not exist!";
@@ -541,7 +1288,7 @@ void Graph<V,E>::mCheckVertex(size_t vertex_id)const
 template<typename V,typename E>
 void Graph<V,E>::mCheckIterator(const VerticesIterator& vi)const
 {
-    if(vi.vecPtr!=&this->mVertices)
+    if(vi.graphPtr!=this)
     {
         throw std::runtime_error("[Graph] Incorrect iterator");
     }
@@ -550,7 +1297,7 @@ void Graph<V,E>::mCheckIterator(const VerticesIterator& vi)const
 template<typename V,typename E>
 void Graph<V,E>::mCheckIterator(const EdgesIterator& ei)const
 {
-    if(ei.vecPtr != &this->mEdges)
+    if(ei.graphPtr != this)
     {
         throw std::runtime_error("[Graph] Incorrect iterator");
     }
@@ -566,10 +1313,15 @@ void Graph<V,E>::printNeighborhoodMatrix()const
     std::cout<<"NrOfEdges:"<<mEdgesNumber<<std::endl;
 
     {
-        std::size_t width = this->mEdges.size();
-        std::size_t height = width>0?this->mEdges[0].size():0;
+        // wiersze mogą być krótsze niż liczba wierzchołków, ale nie dłuższe
+        std::size_t width = this->mEdges->size();
+        std::size_t height = 0;
+        for(std::size_t i=0;i<width;++i)
+        {
+            if(this->mRow(i)!=nullptr)height = std::max(height,this->mRow(i)->size());
+        }
 
-        if(width!=vertices_number || height!=vertices_number)
+        if(width!=vertices_number || height>vertices_number)
         {
             std::cout<<"[Incorrect matrix]"<<std::endl;
             std::cout<<"Width:"<<width<<std::endl;
@@ -596,7 +1348,7 @@ void Graph<V,E>::printNeighborhoodMatrix()const
         std::cout<<"+\n";
         for(x=0;x<vertices_number;++x)
         {
-            std::cout<<"| "<<this->mEdges[y][x].has_value()<<" ";
+            std::cout<<"| "<<this->edgeExist(y,x)<<" ";
         }
         std::cout<<"|\n";
     }
@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -7,8 +7,32 @@ SOURCES += \
         main.cpp
 
 HEADERS += \
+    BitMatrix.hpp \
+    ConcurrentGraph.hpp \
     DFS.hpp \
+    DynamicShortestPaths.hpp \
     Graph.hpp \
     GraphTest.hpp \
+    GridGraph.hpp \
+    QueryExecutor.hpp \
+    ShortestPathCache.hpp \
+    SpatialIndex.hpp \
+    VertexIndex.hpp \
     a_star.hpp \
-    dijkstra.hpp
+    analytics.hpp \
+    batch_shortest_paths.hpp \
+    betweenness.hpp \
+    dag_paths.hpp \
+    dijkstra.hpp \
+    floyd_warshall.hpp \
+    integer_shortest_paths.hpp \
+    jump_point_search.hpp \
+    k_shortest_paths.hpp \
+    minimum_spanning_tree.hpp \
+    parallel.hpp \
+    reachability.hpp \
+    reorder.hpp \
+    simd.hpp \
+    tracing.hpp \
+    traversal_generators.hpp \
+    triangles.hpp
@@ -2,9 +2,34 @@
 #include <iostream>
 #include <cstdint>
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <cstddef>
+#include <memory_resource>
 #include "Graph.hpp"
 #include "dijkstra.hpp"
 #include "a_star.hpp"
+#include "dag_paths.hpp"
+#include "jump_point_search.hpp"
+#include "VertexIndex.hpp"
+#include "reachability.hpp"
+#include "floyd_warshall.hpp"
+#include "ShortestPathCache.hpp"
+#include "DynamicShortestPaths.hpp"
+#include "ConcurrentGraph.hpp"
+#include "SpatialIndex.hpp"
+#include "k_shortest_paths.hpp"
+#include "batch_shortest_paths.hpp"
+#include "minimum_spanning_tree.hpp"
+#include "analytics.hpp"
+#include "reorder.hpp"
+#include "QueryExecutor.hpp"
+#include "traversal_generators.hpp"
+#include "tracing.hpp"
+#include "integer_shortest_paths.hpp"
+#include "betweenness.hpp"
+#include "triangles.hpp"
 
 using namespace std;
 
@@ -182,7 +207,8 @@ void graphTest()
     }
 
     {
-        Graph<std::pair<float, float>, double> g;
+        // krawędzie siatki są nieskierowane - każda jest dodawana raz
+        Graph<std::pair<float, float>, double> g(GraphKind::Undirected);
 
         constexpr std::size_t grid_size = 16u;
         const auto sqrt_2 = std::sqrt(2.);
@@ -212,32 +238,29 @@ void graphTest()
                 if(j < grid_size - 1u)
                 {
                     g.insertEdge(i * grid_size + j, i * grid_size + j + 1u, 1.);
-                    g.insertEdge(i * grid_size + j + 1u, i * grid_size + j, 1.);
                 }
                 if(i < grid_size - 1u)
                 {
                     g.insertEdge(i * grid_size + j, (i + 1u) * grid_size + j, 1.);
-                    g.insertEdge((i + 1u) * grid_size + j, i * grid_size + j, 1.);
                 }
                 if(i < grid_size - 1u && j < grid_size - 1u)
                 {
                     g.insertEdge(i * grid_size + j, (i + 1u) * grid_size + j + 1u, sqrt_2);
-                    g.insertEdge((i + 1u) * grid_size + j + 1u, i * grid_size + j, sqrt_2);
                     g.insertEdge(i * grid_size + j + 1u, (i + 1u) * grid_size + j, sqrt_2);
-                    g.insertEdge((i + 1u) * grid_size + j, i * grid_size + j + 1u, sqrt_2);
                 }
             }
         }
 
+        VertexIndex<std::pair<float, float>, double> vertex_index(g);
         for(std::size_t j = 1u; j < grid_size - 1u; ++j)
         {
-            g.removeVertex(std::find(g.beginVertices(), g.endVertices(), std::make_pair(static_cast<float>(j), grid_size / 2.f)).id());
+            g.removeVertex(vertex_index.findVertex(std::make_pair(static_cast<float>(j), grid_size / 2.f)).value());
         }
 
         auto start_data = std::make_pair(grid_size / 2.f, 1.f);
         auto end_data = std::make_pair(grid_size / 2.f + 1.f, grid_size - 1.f);
-        auto start_it = std::find(g.beginVertices(), g.endVertices(), start_data);
-        auto end_it = std::find(g.beginVertices(), g.endVertices(), end_data);
+        auto start_it = g.vertex(vertex_index.findVertex(start_data).value_or(g.nrOfVertices()));
+        auto end_it = g.vertex(vertex_index.findVertex(end_data).value_or(g.nrOfVertices()));
         if(start_it != g.endVertices() && end_it != g.endVertices())
         {
             auto [shortest_path_distance, shortest_path] = dijkstra<std::pair<float, float>, double>(g, start_it.id(), end_it.id(), [](const double& e) -> double { return e; });
@@ -300,5 +323,615 @@ void graphTest()
 
             std::cout << std::endl;
         }//*/
+
+        // każda pełna komórka siatki (obie przekątne) to 4 trójkąty
+        auto grid_triangles = triangles(g);
+        auto bitset_triangles = triangles(g, TriangleMethod::Bitset);
+        auto clustering = clusteringCoefficients(g);
+        std::cout << "Grid triangles (merge / bitset): " << grid_triangles.total << " / " << bitset_triangles.total << std::endl;
+        std::cout << "Triangles through [" << start_data.first << ", " << start_data.second << "]: " << grid_triangles.vertices[start_it.id()]
+                  << ", clustering coefficient: " << clustering[start_it.id()] << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("job " + std::to_string(i)); }
+        g.insertEdge(0, 1, 5.);
+        g.insertEdge(0, 2, 3.);
+        g.insertEdge(1, 2, 2.);
+        g.insertEdge(1, 3, 6.);
+        g.insertEdge(2, 3, 7.);
+        g.insertEdge(2, 4, 4.);
+        g.insertEdge(2, 5, 2.);
+        g.insertEdge(3, 4, -1.);
+        g.insertEdge(4, 5, -2.);
+
+        auto topological_order = topologicalSort(g);
+        std::cout << "Topological order: ";
+        for(auto& v_id : topological_order.value()) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+
+        auto [shortest_path_distance, shortest_path] = dagShortestPaths<std::string, double>(g, 0u, 5u, [](const double& e) -> double { return e; });
+        std::cout << "DAG shortest distance from 0 to 5: " << shortest_path_distance << std::endl;
+        std::cout << "Path from 0 to 5:" << std::endl;
+        for(auto& v_id : shortest_path) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+
+        std::tie(shortest_path_distance, shortest_path) = criticalPath<std::string, double>(g, [](const double& e) -> double { return e; });
+        std::cout << "Critical path length: " << shortest_path_distance << std::endl;
+        std::cout << "Critical path:" << std::endl;
+        for(auto& v_id : shortest_path) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+
+        g.insertEdge(5, 0, 1.);
+        std::cout << "Acyclic after inserting 5->0: " << isAcyclic(g) << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        constexpr std::size_t grid_size = 16u;
+        GridGraph g(grid_size, grid_size);
+        for(std::size_t j = 1u; j < grid_size - 1u; ++j) { g.setPassable(grid_size / 2u, j, false); }
+
+        std::size_t start_id = g.id(grid_size / 2u - 1u, 1u);
+        std::size_t end_id = g.id(grid_size / 2u + 1u, grid_size - 1u);
+
+        auto [shortest_path_distance, shortest_path] = astar(g, start_id, end_id, GridGraph::octileHeuristics);
+        std::cout << "GridGraph AStar (octile) results:" << std::endl;
+        std::cout << "\tDistance: " << shortest_path_distance << std::endl;
+        std::cout << "\tPath (data): ";
+        for(auto& v_id : shortest_path) { std::cout << "[" << g.coordinates(v_id).first << ", " << g.coordinates(v_id).second << "], "; }
+        std::cout << std::endl;
+
+        std::tie(shortest_path_distance, shortest_path) = jumpPointSearch(g, start_id, end_id);
+        std::cout << "GridGraph JPS results:" << std::endl;
+        std::cout << "\tDistance: " << shortest_path_distance << std::endl;
+        std::cout << "\tPath (data): ";
+        for(auto& v_id : shortest_path) { std::cout << "[" << g.coordinates(v_id).first << ", " << g.coordinates(v_id).second << "], "; }
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("job " + std::to_string(i)); }
+        g.insertEdge(0, 1, 5.);
+        g.insertEdge(0, 2, 3.);
+        g.insertEdge(1, 2, 2.);
+        g.insertEdge(2, 4, 4.);
+        g.insertEdge(3, 4, -1.);
+        g.insertEdge(4, 5, -2.);
+
+        TransitiveClosure closure(g);
+        ReachabilityIndex index(g);
+        std::cout << "Reachability (closure / 2-hop labels):" << std::endl;
+        for(std::size_t u = 0u; u < g.nrOfVertices(); ++u)
+        {
+            std::cout << "\tFrom " << u << ": ";
+            for(std::size_t v = 0u; v < g.nrOfVertices(); ++v) { std::cout << closure.reachable(u, v) << index.reachable(u, v) << " "; }
+            std::cout << std::endl;
+        }
+
+        g.insertEdge(5, 3, 1.);
+        std::cout << "Components after inserting 5->3: " << TransitiveClosure(g).nrOfComponents() << ", "
+                  << ReachabilityIndex(g).nrOfComponents() << std::endl;
+        std::cout << "3 reaches 5: " << ReachabilityIndex(g).reachable(3, 5) << ", 5 reaches 0: " << ReachabilityIndex(g).reachable(5, 0) << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        for(std::size_t i = 0u; i < g.nrOfVertices(); ++i)
+        {
+            for(std::size_t j = 0u; j < g.nrOfVertices(); ++j)
+            {
+                if(i != j && (i + j) % 3u != 0u) { g.insertEdge(i, j, (i + 2. * j) / 2.); }
+            }
+        }
+
+        AllPairsShortestPaths<double> all_pairs(g);
+        bool same_as_dijkstra = true;
+        std::cout << "Floyd-Warshall distances:" << std::endl;
+        for(std::size_t u = 0u; u < g.nrOfVertices(); ++u)
+        {
+            std::cout << "\t";
+            for(std::size_t v = 0u; v < g.nrOfVertices(); ++v)
+            {
+                if(all_pairs.distance(u, v) == std::numeric_limits<double>::max()) { std::cout << "- "; }
+                else { std::cout << all_pairs.distance(u, v) << " "; }
+                if(u != v)
+                {
+                    auto [shortest_path_distance, shortest_path] = dijkstra<std::string, double>(g, u, v, [](const double& e) -> double { return e; });
+                    same_as_dijkstra = same_as_dijkstra && shortest_path_distance == all_pairs.distance(u, v);
+                }
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Same as dijkstra: " << same_as_dijkstra << std::endl;
+        std::cout << "Path from 0 to 5: ";
+        for(auto& v_id : all_pairs.path(0u, 5u)) { std::cout << v_id << ", "; }
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 4u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(1, 2, 1.);
+        g.insertEdge(2, 3, 1.);
+        g.insertEdge(0, 3, 5.);
+
+        ShortestPathCache<std::string, double> cache(g, 64u, 4u);
+        for(std::size_t i = 0u; i < 3u; ++i) { cache.dijkstra(0u, 3u, 0u); }
+        std::cout << "Cached distance from 0 to 3: " << cache.dijkstra(0u, 3u, 0u).first << ", hits: " << cache.hits() << ", misses: " << cache.misses() << std::endl;
+        g.removeEdge(1, 2);
+        std::cout << "Cached distance from 0 to 3 after removing 1->2: " << cache.dijkstra(0u, 3u, 0u).first << ", hits: " << cache.hits() << ", misses: " << cache.misses() << std::endl;
+        *g.edge(0, 3) = 4.;
+        std::cout << "Cached distance from 0 to 3 after writing 4 through an edge iterator: " << cache.dijkstra(0u, 3u, 0u).first << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 5u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(1, 2, 1.);
+        g.insertEdge(2, 3, 1.);
+        g.insertEdge(0, 3, 5.);
+        g.insertEdge(3, 4, 1.);
+
+        DynamicShortestPaths<std::string, double> dynamic_paths(g, 0u);
+        std::cout << "Dynamic distance from 0 to 4: " << dynamic_paths.distance(4u) << std::endl;
+        g.removeEdge(1, 2);
+        std::cout << "Dynamic distance from 0 to 4 after removing 1->2: " << dynamic_paths.distance(4u)
+                  << " (same as dijkstra: " << (dynamic_paths.distance(4u) == dijkstra<std::string, double>(g, 0u, 4u, [](const double& e) -> double { return e; }).first)
+                  << ", vertices updated: " << dynamic_paths.lastUpdateSize() << ")" << std::endl;
+        std::cout << "Path from 0 to 4: ";
+        for(auto& v_id : dynamic_paths.path(4u)) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+        for(std::size_t i = 0u; i < 5000u; ++i) { g.vertexData(i % 4u); }
+        std::cout << "Dynamic distance from 0 to 4 after 5000 vertexData() calls: " << dynamic_paths.distance(4u) << std::endl;
+        g.removeVertex(0);
+        try
+        {
+            dynamic_paths.distance(3u);
+        }
+        catch(const std::exception& e)
+        {
+            std::cout << "After removing the source: " << e.what() << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> initial;
+        for(std::size_t i = 0u; i < 8u; ++i) { initial.insertVertex("data " + std::to_string(i)); }
+        ConcurrentGraph<std::string, double> concurrent_graph(std::move(initial));
+
+        auto old_snapshot = concurrent_graph.snapshot();
+        // krawędzie są dodawane parami - czytelnik nigdy nie może zobaczyć nieparzystej liczby krawędzi
+        std::atomic<bool> consistent(true), done(false);
+        std::thread reader([&]() {
+            while(!done.load())
+            {
+                auto snapshot = concurrent_graph.snapshot();
+                if(snapshot->nrOfEdges() % 2u != 0u) { consistent = false; }
+            }
+        });
+        for(std::size_t i = 0u; i + 1u < 8u; ++i)
+        {
+            concurrent_graph.update([i](Graph<std::string, double>& graph) {
+                graph.insertEdge(i, i + 1u, 1.);
+                graph.insertEdge(i + 1u, i, 1.);
+            });
+        }
+        done = true;
+        reader.join();
+
+        std::cout << "Concurrent graph edges (old snapshot / new snapshot): " << old_snapshot->nrOfEdges() << " / " << concurrent_graph.snapshot()->nrOfEdges() << std::endl;
+        std::cout << "Reader snapshots consistent: " << consistent.load() << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 4u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(1, 2, 2.);
+        g.insertEdge(2, 3, 3.);
+
+        // kopie współdzielą dane z "g", dopóki nie zostaną zmienione
+        std::vector<Graph<std::string, double>> copies(100u, g);
+        copies[0].insertEdge(3, 0, 4.);
+        copies[1].removeVertex(0);
+        *copies[2].vertex(1) = "changed";
+        for(auto e_it = copies[3].beginEdges(); e_it != copies[3].endEdges(); ++e_it) { *e_it *= 10.; }
+
+        std::cout << "Copy-on-write copies (vertices, edges, label 1->2, vertex 1):" << std::endl;
+        std::cout << "\tOriginal: " << g.nrOfVertices() << ", " << g.nrOfEdges() << ", " << g.edgeLabel(1, 2) << ", " << g.vertexData(1) << std::endl;
+        for(std::size_t i = 0u; i < 4u; ++i)
+        {
+            std::cout << "\tCopy " << i << ": " << copies[i].nrOfVertices() << ", " << copies[i].nrOfEdges() << ", "
+                      << (copies[i].edgeExist(1, 2) ? copies[i].edgeLabel(1, 2) : 0.) << ", " << copies[i].vertexData(1) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::pair<float, float>, double> g;
+        for(std::size_t i = 0u; i < 5u; ++i)
+        {
+            for(std::size_t j = 0u; j < 5u; ++j) { g.insertVertex(std::make_pair(static_cast<float>(2u * i), static_cast<float>(2u * j))); }
+        }
+
+        SpatialIndex<std::pair<float, float>, double> spatial_index(g);
+        auto print_vertex = [&g](std::size_t v_id) { std::cout << "[" << g.vertexData(v_id).first << ", " << g.vertexData(v_id).second << "], "; };
+        std::cout << "Nearest vertex to (3.2, 6.9): ";
+        print_vertex(spatial_index.nearestVertex(3.2, 6.9).value());
+        std::cout << std::endl << "3 nearest vertices to (0.5, 0.4): ";
+        for(auto v_id : spatial_index.kNearestVertices(0.5, 0.4, 3u)) { print_vertex(v_id); }
+        std::cout << std::endl << "Vertices within 2.1 of (4, 4): ";
+        for(auto v_id : spatial_index.verticesWithinRadius(4., 4., 2.1)) { print_vertex(v_id); }
+        g.removeVertex(spatial_index.nearestVertex(3.2, 6.9).value());
+        std::cout << std::endl << "Nearest vertex to (3.2, 6.9) after removing it: ";
+        print_vertex(spatial_index.nearestVertex(3.2, 6.9).value());
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(const char* name : {"C", "D", "E", "F", "G", "H"}) { g.insertVertex(name); }
+        g.insertEdge(0, 1, 3.);
+        g.insertEdge(0, 2, 2.);
+        g.insertEdge(1, 3, 4.);
+        g.insertEdge(2, 1, 1.);
+        g.insertEdge(2, 3, 2.);
+        g.insertEdge(2, 4, 3.);
+        g.insertEdge(3, 4, 2.);
+        g.insertEdge(3, 5, 1.);
+        g.insertEdge(4, 5, 2.);
+
+        std::cout << "3 shortest loopless paths from C to H:" << std::endl;
+        for(auto& [path_length, path] : kShortestPaths<std::string, double>(g, 0u, 5u, 3u))
+        {
+            std::cout << "\t" << path_length << ": ";
+            for(auto& v_id : path) { std::cout << g.vertexData(v_id) << ", "; }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 4.);
+        g.insertEdge(0, 2, 1.);
+        g.insertEdge(2, 1, 1.);
+        g.insertEdge(1, 3, 1.);
+        g.insertEdge(3, 4, 7.);
+        g.insertEdge(2, 4, 9.);
+
+        const std::vector<std::pair<std::size_t, std::size_t>> queries{{0u, 3u}, {0u, 4u}, {2u, 4u}, {4u, 0u}, {0u, 5u}};
+        auto weighted = batchShortestPaths(g, queries);
+        auto unweighted = batchShortestPaths(g, queries, nullptr);
+        std::cout << "Batch queries (weighted / unweighted distance):" << std::endl;
+        for(std::size_t i = 0u; i < queries.size(); ++i)
+        {
+            std::cout << "\t" << queries[i].first << " -> " << queries[i].second << ": ";
+            if(weighted[i].second.empty()) { std::cout << "no path" << std::endl; }
+            else { std::cout << weighted[i].first << " / " << unweighted[i].first << std::endl; }
+        }
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 7u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 7.);
+        g.insertEdge(0, 3, 5.);
+        g.insertEdge(1, 2, 8.);
+        g.insertEdge(1, 3, 9.);
+        g.insertEdge(1, 4, 7.);
+        g.insertEdge(2, 4, 5.);
+        g.insertEdge(3, 4, 15.);
+        g.insertEdge(3, 5, 6.);
+        g.insertEdge(4, 5, 8.);
+        g.insertEdge(4, 6, 9.);
+        g.insertEdge(5, 6, 11.);
+
+        auto prim = primMinimumSpanningTree(g);
+        auto kruskal = kruskalMinimumSpanningTree(g);
+        auto boruvka = boruvkaMinimumSpanningTree(g);
+        std::cout << "Minimum spanning tree weight (Prim / Kruskal / Boruvka): " << prim.first << " / " << kruskal.first << " / " << boruvka.first << std::endl;
+        std::cout << "Same edges: " << (prim.second == kruskal.second && kruskal.second == boruvka.second) << std::endl;
+        std::cout << "Edges: ";
+        for(auto& [y, x] : kruskal.second) { std::cout << "(" << y << ", " << x << "), "; }
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 5u; ++i) { g.insertVertex("page " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(0, 2, 1.);
+        g.insertEdge(1, 2, 1.);
+        g.insertEdge(2, 0, 1.);
+        g.insertEdge(3, 2, 1.);
+        g.insertEdge(2, 4, 1.);
+
+        auto page_rank = pageRank(g);
+        double rank_sum = 0.;
+        std::cout << "PageRank: ";
+        for(auto rank : page_rank.ranks)
+        {
+            std::cout << rank << ", ";
+            rank_sum += rank;
+        }
+        std::cout << std::endl << "\tSum: " << rank_sum << ", converged: " << page_rank.converged(1e-10) << std::endl;
+
+        // gęsta iteracja potęgowa jako odniesienie (wierzchołek 4 nie ma krawędzi wychodzących)
+        const std::size_t n = g.nrOfVertices();
+        std::vector<double> dense_rank(n, 1. / n);
+        for(std::size_t iteration = 0u; iteration < 200u; ++iteration)
+        {
+            std::vector<double> next(n, 0.);
+            for(std::size_t y = 0u; y < n; ++y)
+            {
+                std::size_t out_degree = 0u;
+                for(std::size_t x = 0u; x < n; ++x) { out_degree += g.edgeExist(y, x); }
+                for(std::size_t x = 0u; x < n; ++x)
+                {
+                    if(out_degree == 0u) { next[x] += 0.85 * dense_rank[y] / n; }
+                    else if(g.edgeExist(y, x)) { next[x] += 0.85 * dense_rank[y] / out_degree; }
+                }
+            }
+            for(std::size_t x = 0u; x < n; ++x) { dense_rank[x] = next[x] + 0.15 / n; }
+        }
+        double max_difference = 0.;
+        for(std::size_t x = 0u; x < n; ++x) { max_difference = std::max(max_difference, std::abs(dense_rank[x] - page_rank.ranks[x])); }
+        std::cout << "\tSame as dense power iteration: " << (max_difference < 1e-9) << std::endl;
+
+        std::cout << "Personalized PageRank (seed 3): ";
+        for(auto rank : personalizedPageRank(g, {3u}).ranks) { std::cout << rank << ", "; }
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        // ścieżka, której kolejne wierzchołki mają rozrzucone id
+        Graph<std::string, double> g;
+        const std::vector<std::size_t> path_order{0u, 5u, 2u, 7u, 1u, 6u, 3u, 4u};
+        for(std::size_t i = 0u; i < path_order.size(); ++i) { g.insertVertex("data " + std::to_string(i)); }
+        for(std::size_t i = 0u; i + 1u < path_order.size(); ++i) { g.insertEdge(path_order[i], path_order[i + 1u], 1. + i); }
+
+        auto bandwidth = [](const Graph<std::string, double>& graph) {
+            std::size_t result = 0u;
+            for(std::size_t y = 0u; y < graph.nrOfVertices(); ++y)
+            {
+                for(std::size_t x = graph.nextNeighbor(y, 0u); x < graph.nrOfVertices(); x = graph.nextNeighbor(y, x + 1u)) { result = std::max(result, y > x ? y - x : x - y); }
+            }
+            return result;
+        };
+        const double distance_before = dijkstra<std::string, double>(g, 0u, 4u, [](const double& e) -> double { return e; }).first;
+        std::cout << "Bandwidth before reordering: " << bandwidth(g) << std::endl;
+        auto [old_to_new, new_to_old] = reorder(g, ReorderStrategy::ReverseCuthillMcKee);
+        std::cout << "Bandwidth after RCM: " << bandwidth(g) << std::endl;
+        std::cout << "Distance from \"data 0\" to \"data 4\" before / after: " << distance_before << " / "
+                  << dijkstra<std::string, double>(g, old_to_new[0], old_to_new[4], [](const double& e) -> double { return e; }).first << std::endl;
+        std::cout << "New order (data): ";
+        for(std::size_t v_id = 0u; v_id < g.nrOfVertices(); ++v_id) { std::cout << g.vertexData(v_id) << ", "; }
+        std::cout << std::endl << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        for(std::size_t i = 0u; i < g.nrOfVertices(); ++i)
+        {
+            g.insertEdge(i, (i + 1u) % g.nrOfVertices(), 1.);
+            g.insertEdge(i, (i + 2u) % g.nrOfVertices(), 3.);
+        }
+
+        QueryExecutor<std::string, double> executor(g, 4u);
+        std::vector<QueryExecutor<std::string, double>::Query<QueryExecutor<std::string, double>::path_type>> queries;
+        for(std::size_t i = 1u; i < g.nrOfVertices(); ++i) { queries.push_back(executor.shortestPath(0u, i)); }
+        // migawka nie widzi zmian oryginału
+        g.removeEdge(0, 1);
+        auto traversal = executor.traversal(0u);
+        auto expired = executor.shortestPath(0u, 3u, [](const double& e) -> double { return e; }, QueryExecutor<std::string, double>::clock::now() - std::chrono::seconds(1));
+
+        std::cout << "Executor distances from 0: ";
+        for(auto& query : queries) { std::cout << query.get().first << ", "; }
+        std::cout << std::endl << "Executor BFS(0): ";
+        for(auto v_id : traversal.get()) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+        try
+        {
+            expired.get();
+        }
+        catch(const std::exception& e)
+        {
+            std::cout << "Query past its deadline: " << e.what() << std::endl;
+        }
+        auto statistics = executor.statistics();
+        std::cout << "Executor statistics (completed / expired): " << statistics.completed << " / " << statistics.expired << std::endl;
+        std::cout << std::endl;
+    }
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 6u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(0, 2, 1.);
+        g.insertEdge(1, 3, 1.);
+        g.insertEdge(2, 4, 1.);
+        g.insertEdge(3, 5, 1.);
+
+        CoroutineArena arena;
+        std::cout << "Generator DFS(0): ";
+        for(auto v_id : dfsVertices(g, 0u, &arena)) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+        std::cout << "Generator BFS(0): ";
+        for(auto v_id : bfsVertices(g, 0u, &arena)) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+        std::cout << "Generator BFS(0), depth <= 1: ";
+        for(auto v_id : boundedVertices(g, 0u, 1u, &arena)) { std::cout << v_id << ", "; }
+        std::cout << std::endl;
+        std::cout << "Generator BFS(0), first 3: ";
+        std::size_t taken = 0u;
+        for(auto v_id : bfsVertices(g, 0u, &arena))
+        {
+            if(taken++ == 3u) { break; }
+            std::cout << v_id << ", ";
+        }
+        std::cout << std::endl << std::endl;
+    }
+#endif
+
+#if defined(GRAPH_TRACING)
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 4u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        g.insertEdge(0, 1, 1.);
+        g.insertEdge(1, 2, 1.);
+        g.insertEdge(2, 3, 1.);
+
+        Tracer::instance().clear();
+        dijkstra<std::string, double>(g, 0u, 3u, [](const double& e) -> double { return e; });
+        std::ostringstream trace;
+        Tracer::instance().writeChromeTrace(trace);
+
+        // nazwy odcinków w kolejności zakończenia (czasy zależą od przebiegu, więc nie są wypisywane)
+        std::cout << "Trace spans of dijkstra: ";
+        const std::string text = trace.str();
+        for(std::size_t pos = text.find("\"name\":\""); pos != std::string::npos; pos = text.find("\"name\":\"", pos + 1u))
+        {
+            const std::size_t begin = pos + 8u;
+            std::cout << text.substr(begin, text.find('"', begin) - begin) << ", ";
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+    }
+#endif
+
+    {
+        // graf i bufory szukania w jednym buforze - "null_memory_resource" zgłosi wyjątek, gdyby bufor się skończył
+        std::vector<std::byte> graph_buffer(1u << 20), scratch_buffer(1u << 16);
+        std::pmr::monotonic_buffer_resource graph_resource(graph_buffer.data(), graph_buffer.size(), std::pmr::null_memory_resource());
+        std::pmr::monotonic_buffer_resource scratch_resource(scratch_buffer.data(), scratch_buffer.size(), std::pmr::null_memory_resource());
+
+        Graph<int, double> g(&graph_resource);
+        for(int i = 0; i < 64; ++i) { g.insertVertex(i); }
+        for(std::size_t i = 0u; i + 1u < g.nrOfVertices(); ++i) { g.insertEdge(i, i + 1u, 1.); }
+        g.insertEdge(0, 32, 10.);
+
+        auto [shortest_path_distance, shortest_path] = dijkstra<int, double>(g, 0u, 63u, [](const double& e) -> double { return e; }, &scratch_resource);
+        std::cout << "Distance from 0 to 63 (arena-allocated graph and search): " << shortest_path_distance << ", path length: " << shortest_path.size() << std::endl;
+        std::cout << "Graph uses the arena: " << (g.memoryResource() == &graph_resource) << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 200u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+        for(std::size_t i = 0u; i < g.nrOfVertices(); i += 7u) { g.insertEdge(0, i, 1.); }
+        g.insertEdge(150, 0, 1.);
+        g.insertEdge(199, 0, 1.);
+
+        std::cout << "Degrees of 0 (out / in): " << g.outDegree(0) << " / " << g.inDegree(0) << ", of 7: " << g.outDegree(7) << " / " << g.inDegree(7) << std::endl;
+        std::cout << "Neighbours of 0 above 150: ";
+        for(std::size_t x = g.nextNeighbor(0, 151u); x < g.nrOfVertices(); x = g.nextNeighbor(0, x + 1u)) { std::cout << x << ", "; }
+        std::size_t edges_number = 0u;
+        for(auto e_it = g.beginEdges(); e_it != g.endEdges(); ++e_it) { ++edges_number; }
+        std::cout << std::endl << "Edges enumerated: " << edges_number << " of " << g.nrOfEdges() << std::endl;
+        g.removeVertex(7);
+        std::cout << "Out degree of 0 after removing vertex 7: " << g.outDegree(0) << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, double> g;
+        for(std::size_t i = 0u; i < 100u; ++i) { g.insertVertex("data " + std::to_string(i)); }
+
+        std::vector<Graph<std::string, double>::EdgeUpdate> updates;
+        for(std::size_t i = 0u; i < g.nrOfVertices(); ++i)
+        {
+            updates.push_back({i, (i + 1u) % g.nrOfVertices(), 1.});
+            updates.push_back({i, (i + 10u) % g.nrOfVertices(), 5.});
+        }
+        std::cout << "Batch insert changes: " << g.applyEdgeBatch(updates, 4u) << ", edges: " << g.nrOfEdges() << std::endl;
+
+        // zmiany tej samej krawędzi są wykonywane w kolejności paczki
+        updates.clear();
+        for(std::size_t i = 0u; i < g.nrOfVertices(); i += 2u) { updates.push_back({i, (i + 10u) % g.nrOfVertices(), std::nullopt}); }
+        updates.push_back({0u, 1u, 7.});
+        updates.push_back({0u, 1u, 2.});
+        std::cout << "Batch remove / relabel changes: " << g.applyEdgeBatch(updates, 4u) << ", edges: " << g.nrOfEdges() << ", label 0->1: " << g.edgeLabel(0, 1) << std::endl;
+        std::cout << "Distance from 0 to 50: " << dijkstra<std::string, double>(g, 0u, 50u, [](const double& e) -> double { return e; }).first << std::endl;
+        std::cout << std::endl;
+    }
+
+    {
+        Graph<std::string, unsigned> g;
+        for(std::size_t i = 0u; i < 8u; ++i) { g.insertVertex("stop " + std::to_string(i)); }
+        g.insertEdge(0, 1, 120u);
+        g.insertEdge(0, 2, 300u);
+        g.insertEdge(1, 2, 90u);
+        g.insertEdge(1, 3, 600u);
+        g.insertEdge(2, 3, 240u);
+        g.insertEdge(3, 4, 60u);
+        g.insertEdge(2, 5, 3000u);
+        g.insertEdge(5, 6, 30u);
+        g.insertEdge(4, 6, 5000u);
+
+        std::cout << "Integer shortest paths from 0 (Dial / radix heap / dijkstra):" << std::endl;
+        for(std::size_t v = 4u; v < 8u; ++v)
+        {
+            auto dial = integerDijkstra(g, 0u, v, [](const unsigned& e) -> std::size_t { return e; }, IntegerQueue::Dial);
+            auto radix = integerDijkstra(g, 0u, v, [](const unsigned& e) -> std::size_t { return e; }, IntegerQueue::Radix);
+            auto reference = dijkstra<std::string, unsigned>(g, 0u, v, [](const unsigned& e) -> double { return e; });
+            std::cout << "\tTo " << v << ": ";
+            if(radix.second.empty()) { std::cout << "no path" << std::endl; continue; }
+            std::cout << dial.first << " / " << radix.first << " / " << reference.first << ", path: ";
+            for(auto& v_id : radix.second) { std::cout << v_id << ", "; }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    {
+        // siatka 4x4 z przekątnymi (dłuższymi niż dwa kroki w wersji ważonej), krawędzie nieskierowane
+        constexpr std::size_t grid_size = 4u;
+        Graph<std::pair<float, float>, double> g(GraphKind::Undirected);
+        for(std::size_t i = 0u; i < grid_size; ++i)
+        {
+            for(std::size_t j = 0u; j < grid_size; ++j) { g.insertVertex(std::make_pair(i, j)); }
+        }
+        for(std::size_t i = 0u; i < grid_size; ++i)
+        {
+            for(std::size_t j = 0u; j < grid_size; ++j)
+            {
+                if(j + 1u < grid_size) { g.insertEdge(i * grid_size + j, i * grid_size + j + 1u, 1.); }
+                if(i + 1u < grid_size) { g.insertEdge(i * grid_size + j, (i + 1u) * grid_size + j, 1.); }
+                if(i + 1u < grid_size && j + 1u < grid_size) { g.insertEdge(i * grid_size + j, (i + 1u) * grid_size + j + 1u, 2.5); }
+            }
+        }
+
+        auto exact = betweenness(g);
+        auto weighted = betweenness(g, [](const double& e) -> double { return e; });
+        auto sampled = approximateBetweenness(g, betweennessSamples(g.nrOfVertices(), 0.1), nullptr, 0.1, 7u);
+        std::cout << "Betweenness of grid vertices (unweighted):" << std::endl;
+        for(std::size_t i = 0u; i < grid_size; ++i)
+        {
+            std::cout << "\t";
+            for(std::size_t j = 0u; j < grid_size; ++j) { std::cout << exact.vertices[i * grid_size + j] << " "; }
+            std::cout << std::endl;
+        }
+        bool within_bound = true;
+        for(std::size_t v = 0u; v < g.nrOfVertices(); ++v) { within_bound = within_bound && std::abs(sampled.vertices[v] - exact.vertices[v]) <= sampled.errorBound; }
+        std::cout << "Sampled betweenness (" << sampled.samples << " samples) within its error bound: " << within_bound << std::endl;
+        std::cout << "Weighted betweenness of vertices 1 / 5: " << weighted.vertices[1] << " / " << weighted.vertices[5] << std::endl;
+        std::cout << std::endl;
     }
 }
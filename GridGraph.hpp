@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+// niejawny graf siatki 8-spójnej - wierzchołki i krawędzie nie są przechowywane,
+// pamiętany jest tylko bit "przejezdności" każdej komórki (bloki 8x8 komórek w jednym słowie 64-bitowym)
+// id wierzchołka = y*width + x
+// ruch po przekątnej jest dozwolony tylko gdy obie sąsiednie komórki w pionie i poziomie są przejezdne
+// koszt ruchu: 1 w pionie i poziomie, sqrt(2) po przekątnej
+class GridGraph
+{
+public:
+    static constexpr std::size_t BLOCK = 8;
+
+    GridGraph(std::size_t width, std::size_t height, bool passable = true)
+        :mWidth(width),mHeight(height),
+          mBlocksPerRow((width+BLOCK-1)/BLOCK),
+          mBlocked(mBlocksPerRow*((height+BLOCK-1)/BLOCK), passable ? 0 : ~std::uint64_t(0))
+    {
+
+    }
+
+    std::size_t width() const
+    {
+        return this->mWidth;
+    }
+    std::size_t height() const
+    {
+        return this->mHeight;
+    }
+    // zwraca ilość wierzchołków (komórek) siatki
+    // O(1)
+    std::size_t nrOfVertices() const
+    {
+        return this->mWidth*this->mHeight;
+    }
+
+    // zwraca id wierzchołka o podanych współrzędnych
+    std::size_t id(std::size_t x, std::size_t y) const
+    {
+        this->mCheckCell(x,y);
+        return y*this->mWidth+x;
+    }
+    // zwraca współrzędne (x, y) wierzchołka o podanym id
+    std::pair<std::size_t, std::size_t> coordinates(std::size_t vertex_id) const
+    {
+        this->mCheckVertex(vertex_id);
+        return std::make_pair(vertex_id%this->mWidth,vertex_id/this->mWidth);
+    }
+
+    bool passable(std::size_t x, std::size_t y) const
+    {
+        this->mCheckCell(x,y);
+        return this->mPassable(x,y);
+    }
+    bool passable(std::size_t vertex_id) const
+    {
+        this->mCheckVertex(vertex_id);
+        return this->mPassable(vertex_id%this->mWidth,vertex_id/this->mWidth);
+    }
+    void setPassable(std::size_t x, std::size_t y, bool passable)
+    {
+        this->mCheckCell(x,y);
+        std::uint64_t bit = std::uint64_t(1)<<this->mBit(x,y);
+        if(passable)this->mBlocked[this->mBlock(x,y)] &= ~bit;
+        else this->mBlocked[this->mBlock(x,y)] |= bit;
+    }
+
+    // wywołuje "f(neighbour_id, cost)" dla każdego sąsiada, do którego można przejść z podanego wierzchołka
+    template<typename F>
+    void forEachNeighbour(std::size_t vertex_id, F f) const
+    {
+        this->mCheckVertex(vertex_id);
+        const std::ptrdiff_t x = static_cast<std::ptrdiff_t>(vertex_id%this->mWidth);
+        const std::ptrdiff_t y = static_cast<std::ptrdiff_t>(vertex_id/this->mWidth);
+        const double SQRT_2 = std::sqrt(2.);
+
+        for(std::ptrdiff_t dy=-1;dy<=1;++dy)
+        {
+            for(std::ptrdiff_t dx=-1;dx<=1;++dx)
+            {
+                if(dx==0&&dy==0)continue;
+                if(!this->walkable(x+dx,y+dy))continue;
+
+                if(dx!=0&&dy!=0)
+                {
+                    if(!this->walkable(x+dx,y)||!this->walkable(x,y+dy))continue;
+                    f(static_cast<std::size_t>((y+dy)*static_cast<std::ptrdiff_t>(this->mWidth)+x+dx),SQRT_2);
+                }
+                else
+                {
+                    f(static_cast<std::size_t>((y+dy)*static_cast<std::ptrdiff_t>(this->mWidth)+x+dx),1.);
+                }
+            }
+        }
+    }
+
+    // true dla przejezdnej komórki wewnątrz siatki, false dla pozostałych (również spoza siatki)
+    bool walkable(std::ptrdiff_t x, std::ptrdiff_t y) const
+    {
+        return x>=0 && y>=0
+                && static_cast<std::size_t>(x)<this->mWidth
+                && static_cast<std::size_t>(y)<this->mHeight
+                && this->mPassable(static_cast<std::size_t>(x),static_cast<std::size_t>(y));
+    }
+
+    // odległość w metryce "octile" - dopuszczalna heurystyka dla "astar()" na tej siatce
+    static double octileHeuristics(const GridGraph& grid, std::size_t actual_vertex_id, std::size_t end_vertex_id)
+    {
+        auto [x1, y1] = grid.coordinates(actual_vertex_id);
+        auto [x2, y2] = grid.coordinates(end_vertex_id);
+        double dx = std::abs(static_cast<double>(x1)-static_cast<double>(x2));
+        double dy = std::abs(static_cast<double>(y1)-static_cast<double>(y2));
+        return std::max(dx,dy)+(std::sqrt(2.)-1.)*std::min(dx,dy);
+    }
+    static double euclideanHeuristics(const GridGraph& grid, std::size_t actual_vertex_id, std::size_t end_vertex_id)
+    {
+        auto [x1, y1] = grid.coordinates(actual_vertex_id);
+        auto [x2, y2] = grid.coordinates(end_vertex_id);
+        return std::hypot(static_cast<double>(x1)-static_cast<double>(x2),
+                          static_cast<double>(y1)-static_cast<double>(y2));
+    }
+
+    // zwraca pamięć zajmowaną przez siatkę (w bajtach)
+    std::size_t memoryUsage() const
+    {
+        return this->mBlocked.size()*sizeof(std::uint64_t);
+    }
+private:
+    std::size_t mWidth;
+    std::size_t mHeight;
+    std::size_t mBlocksPerRow;
+    std::vector<std::uint64_t> mBlocked;
+
+    std::size_t mBlock(std::size_t x, std::size_t y) const
+    {
+        return (y/BLOCK)*this->mBlocksPerRow+x/BLOCK;
+    }
+    std::size_t mBit(std::size_t x, std::size_t y) const
+    {
+        return (y%BLOCK)*BLOCK+x%BLOCK;
+    }
+    bool mPassable(std::size_t x, std::size_t y) const
+    {
+        return !((this->mBlocked[this->mBlock(x,y)]>>this->mBit(x,y))&1u);
+    }
+
+    void mCheckCell(std::size_t x, std::size_t y) const
+    {
+        if(x>=this->mWidth||y>=this->mHeight)
+        {
+            throw std::runtime_error("[GridGraph] Cell["+std::to_string(x)+"]["
+                                     +std::to_string(y)+"] does not exist!");
+        }
+    }
+    void mCheckVertex(std::size_t vertex_id) const
+    {
+        if(vertex_id>=this->nrOfVertices())
+        {
+            throw std::runtime_error("[GridGraph] Vertex["+std::to_string(vertex_id)+"] does not exist!");
+        }
+    }
+};
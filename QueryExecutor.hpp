@@ -0,0 +1,622 @@
+#pragma once
+#include "Graph.hpp"
+#include "analytics.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+// wykonawca zapytań do grafu: stała pula wątków z kradzieżą pracy, zamiast osobnego wątku na każde zapytanie
+// - zapytania działają na niezmiennej migawce grafu (kopia z współdzieleniem danych, patrz "Graph"),
+//   więc oryginał może być zmieniany w trakcie; "setGraph()" podmienia migawkę dla kolejnych zapytań
+// - migawka ma gotowe listy sąsiedztwa, a każdy wątek ma własne bufory szukań ("Workspace"),
+//   używane ponownie przez kolejne zapytania bez zerowania
+// - każdy wątek ma własną kolejkę: zapytania są rozdzielane po kolejkach po kolei, wątek bierze zapytania
+//   z początku swojej kolejki, a gdy jest pusta - kradnie z końca kolejek innych wątków
+// - zapytanie można anulować ("Query::cancel()") i można mu nadać termin; zapytanie anulowane lub przeterminowane
+//   kończy się wyjątkiem std::runtime_error zgłaszanym przez "Query::get()" (wbudowane szukania sprawdzają to
+//   również w trakcie pracy, "pageRank()" - tylko przed startem)
+template<typename V, typename E>
+class QueryExecutor
+{
+public:
+    using clock = std::chrono::steady_clock;
+    using path_type = std::pair<double, std::vector<std::size_t>>;
+
+    // bufory szukań jednego wątku, wpis jest ważny tylko gdy jego znacznik równa się "stamp"
+    class Workspace
+    {
+    public:
+        std::vector<double> distance;
+        std::vector<std::size_t> precursor;
+        std::vector<std::uint64_t> seenStamp;
+        std::vector<std::uint64_t> closedStamp;
+        std::vector<std::pair<double, std::size_t>> heap;
+        std::vector<std::size_t> list;
+        std::uint64_t stamp = 0;
+
+        // unieważnia poprzednie wpisy, O(1) poza powiększaniem buforów
+        void reset(std::size_t verticesNumber)
+        {
+            if(this->seenStamp.size()<verticesNumber)
+            {
+                this->distance.resize(verticesNumber);
+                this->precursor.resize(verticesNumber);
+                this->seenStamp.resize(verticesNumber,0);
+                this->closedStamp.resize(verticesNumber,0);
+            }
+            ++this->stamp;
+            this->heap.clear();
+            this->list.clear();
+        }
+        bool seen(std::size_t v) const
+        {
+            return this->seenStamp[v]==this->stamp;
+        }
+        bool closed(std::size_t v) const
+        {
+            return this->closedStamp[v]==this->stamp;
+        }
+    };
+
+    // niezmienna migawka grafu z listami sąsiedztwa (CSR), "labels" wskazują etykiety w "graph"
+    class Snapshot
+    {
+    public:
+        explicit Snapshot(const Graph<V, E>& source)
+            :graph(source)
+        {
+            const std::size_t verticesNumber = this->graph.nrOfVertices();
+            this->offsets.assign(verticesNumber+1,0);
+            for(std::size_t y=0;y<verticesNumber;++y)
+            {
+                for(std::size_t x=this->graph.nextNeighbor(y,0);x<verticesNumber;x=this->graph.nextNeighbor(y,x+1))
+                {
+                    this->targets.push_back(x);
+                    this->labels.push_back(&this->graph.edgeLabel(y,x));
+                }
+                this->offsets[y+1] = this->targets.size();
+            }
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        const Graph<V, E> graph;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+        std::vector<const E*> labels;
+    };
+
+    // stan współdzielony przez zapytanie i jego uchwyt
+    class QueryState
+    {
+    public:
+        explicit QueryState(clock::time_point d)
+            :cancelled(false),deadline(d),submitted(clock::now())
+        {
+
+        }
+        std::atomic<bool> cancelled;
+        const clock::time_point deadline;
+        const clock::time_point submitted;
+    };
+
+    // to, co widzi wykonywane zapytanie
+    class QueryContext
+    {
+    public:
+        QueryContext(const Snapshot& s, Workspace& w, const QueryState& st, const std::atomic<bool>& stop)
+            :snapshot(s),workspace(w),mState(&st),mStop(&stop)
+        {
+
+        }
+        const Graph<V, E>& graph() const
+        {
+            return this->snapshot.graph;
+        }
+        // true jeśli zapytanie anulowano, minął jego termin albo wykonawca jest niszczony
+        bool stopRequested() const
+        {
+            return this->mState->cancelled.load(std::memory_order_relaxed)||
+                    this->mStop->load(std::memory_order_relaxed)||
+                    clock::now()>this->mState->deadline;
+        }
+        // zgłasza wyjątek, jeśli zapytanie ma zostać przerwane
+        void check() const
+        {
+            if(this->mState->cancelled.load(std::memory_order_relaxed))
+            {
+                throw std::runtime_error("[Query executor] Query cancelled");
+            }
+            if(this->mStop->load(std::memory_order_relaxed))
+            {
+                throw std::runtime_error("[Query executor] Executor stopped");
+            }
+            if(clock::now()>this->mState->deadline)
+            {
+                throw std::runtime_error("[Query executor] Query deadline exceeded");
+            }
+        }
+
+        const Snapshot& snapshot;
+        Workspace& workspace;
+    private:
+        const QueryState* mState;
+        const std::atomic<bool>* mStop;
+    };
+
+    // uchwyt do wyniku zapytania
+    template<typename R>
+    class Query
+    {
+        friend class QueryExecutor;
+
+        Query(std::future<R>&& future, std::shared_ptr<QueryState> state)
+            :mFuture(std::move(future)),mState(std::move(state))
+        {
+
+        }
+    public:
+        // czeka na wynik (tylko raz), zgłasza wyjątek zapytania
+        R get()
+        {
+            return this->mFuture.get();
+        }
+        void wait() const
+        {
+            this->mFuture.wait();
+        }
+        // zwraca true, jeśli wynik jest gotowy przed upływem "timeout"
+        template<typename Rep, typename Period>
+        bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            return this->mFuture.wait_for(timeout)==std::future_status::ready;
+        }
+        bool ready() const
+        {
+            return this->waitFor(std::chrono::seconds(0));
+        }
+        // prosi o przerwanie zapytania - nie czeka na jego zakończenie
+        void cancel()
+        {
+            this->mState->cancelled.store(true);
+        }
+    private:
+        std::future<R> mFuture;
+        std::shared_ptr<QueryState> mState;
+    };
+
+    class Statistics
+    {
+    public:
+        // zapytania oczekujące w kolejkach
+        std::size_t queueDepth;
+        // zapytania właśnie wykonywane
+        std::size_t running;
+        std::uint64_t submitted;
+        std::uint64_t completed;
+        std::uint64_t cancelled;
+        std::uint64_t expired;
+        std::uint64_t failed;
+        // czas od zgłoszenia do zakończenia zapytań zakończonych sukcesem
+        std::chrono::nanoseconds meanLatency;
+        std::chrono::nanoseconds maxLatency;
+    };
+
+    explicit QueryExecutor(const Graph<V, E>& graph, std::size_t threadsNumber = 0)
+        :mSnapshot(std::make_shared<const Snapshot>(graph)),
+          mThreadsNumber(threadsNumberOrDefault(threadsNumber)),
+          mQueues(new WorkerQueue[mThreadsNumber]),
+          mWorkspaces(mThreadsNumber),
+          mStop(false),mPending(0),mRunning(0),mNextQueue(0),
+          mSubmitted(0),mCompleted(0),mCancelled(0),mExpired(0),mFailed(0),
+          mLatencyTotal(0),mLatencyMax(0)
+    {
+        this->mThreads.reserve(this->mThreadsNumber);
+        for(std::size_t i=0;i<this->mThreadsNumber;++i)
+        {
+            this->mThreads.emplace_back(&QueryExecutor::mWorker,this,i);
+        }
+    }
+    QueryExecutor(const QueryExecutor&) = delete;
+    QueryExecutor& operator=(const QueryExecutor&) = delete;
+
+    // oczekujące zapytania kończą się wyjątkiem, wykonywane są przerywane
+    ~QueryExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mSleepMutex);
+            this->mStop = true;
+        }
+        this->mWakeUp.notify_all();
+        for(std::thread& t: this->mThreads)
+        {
+            t.join();
+        }
+    }
+
+    // kolejne zapytania będą wykonywane na migawce "graph" (już zgłoszone - na poprzedniej)
+    // O(V^2)
+    void setGraph(const Graph<V, E>& graph)
+    {
+        auto snapshot = std::make_shared<const Snapshot>(graph);
+        std::lock_guard<std::mutex> lock(this->mSnapshotMutex);
+        this->mSnapshot = std::move(snapshot);
+    }
+
+    std::size_t threadsNumber() const
+    {
+        return this->mThreadsNumber;
+    }
+
+    // zgłasza dowolne zapytanie: "job(const QueryContext&)" zwraca wynik zapytania
+    // długie zapytania powinny co jakiś czas wywoływać "context.check()"
+    template<typename F>
+    Query<std::invoke_result_t<F, const QueryContext&>>
+    submit(F job, clock::time_point deadline = clock::time_point::max())
+    {
+        using R = std::invoke_result_t<F, const QueryContext&>;
+        auto state = std::make_shared<QueryState>(deadline);
+        auto promise = std::make_shared<std::promise<R>>();
+        Query<R> query(promise->get_future(),state);
+
+        std::shared_ptr<const Snapshot> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(this->mSnapshotMutex);
+            snapshot = this->mSnapshot;
+        }
+
+        this->mPush([this,job = std::move(job),state,promise,snapshot](Workspace& workspace)
+        {
+            QueryContext context(*snapshot,workspace,*state,this->mStop);
+            try
+            {
+                context.check();
+                // statystyki są aktualizowane przed udostępnieniem wyniku
+                if constexpr(std::is_void_v<R>)
+                {
+                    job(context);
+                    this->mRecordLatency(*state);
+                    promise->set_value();
+                }
+                else
+                {
+                    R result = job(context);
+                    this->mRecordLatency(*state);
+                    promise->set_value(std::move(result));
+                }
+            }
+            catch(...)
+            {
+                if(state->cancelled.load()||this->mStop.load())++this->mCancelled;
+                else if(clock::now()>state->deadline)++this->mExpired;
+                else ++this->mFailed;
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return query;
+    }
+
+    // najkrótsza ścieżka (Dijkstra z kopcem) - wynik jak w "dijkstra()": (długość, id wierzchołków ścieżki),
+    // (std::numeric_limits<double>::max(), {}) gdy ścieżki nie ma; dla start_idx == end_idx - (0, {start_idx})
+    Query<path_type> shortestPath(std::size_t start_idx, std::size_t end_idx,
+                                  std::function<double(const E&)> getEdgeLength =
+                                  [](const E&edge)->double{return edge;},
+                                  clock::time_point deadline = clock::time_point::max())
+    {
+        return this->submit([start_idx,end_idx,getEdgeLength](const QueryContext& context)
+        {
+            return mSearch(context,start_idx,end_idx,getEdgeLength,nullptr);
+        },deadline);
+    }
+
+    // najkrótsza ścieżka A* - heurystyka jak w "astar()" (musi być spójna), wynik jak w "shortestPath()"
+    Query<path_type> astar(std::size_t start_idx, std::size_t end_idx,
+                           std::function<double(const Graph<V, E>&, std::size_t, std::size_t)> heuristics,
+                           std::function<double(const E&)> getEdgeLength =
+                           [](const E&edge)->double{return edge;},
+                           clock::time_point deadline = clock::time_point::max())
+    {
+        return this->submit([start_idx,end_idx,heuristics,getEdgeLength](const QueryContext& context)
+        {
+            return mSearch(context,start_idx,end_idx,getEdgeLength,heuristics);
+        },deadline);
+    }
+
+    // id wierzchołków osiągalnych z "start_idx" w kolejności BFS ("breadthFirst") lub DFS (preorder),
+    // sąsiedzi odwiedzani rosnąco po id
+    Query<std::vector<std::size_t>> traversal(std::size_t start_idx, bool breadthFirst = true,
+                                              clock::time_point deadline = clock::time_point::max())
+    {
+        return this->submit([start_idx,breadthFirst](const QueryContext& context)
+        {
+            return mTraversal(context,start_idx,breadthFirst);
+        },deadline);
+    }
+
+    // PageRank migawki (patrz "pageRank()"), liczony jednym wątkiem puli
+    Query<RankResult<double>> pageRank(double damping = 0.85, double tolerance = 1e-10,
+                                       std::size_t maxIterations = 100,
+                                       clock::time_point deadline = clock::time_point::max())
+    {
+        return this->submit([damping,tolerance,maxIterations](const QueryContext& context)
+        {
+            return ::pageRank<double>(context.graph(),damping,tolerance,maxIterations,nullptr,1);
+        },deadline);
+    }
+
+    Statistics statistics() const
+    {
+        Statistics result;
+        result.queueDepth = this->mPending.load();
+        result.running = this->mRunning.load();
+        result.submitted = this->mSubmitted.load();
+        result.completed = this->mCompleted.load();
+        result.cancelled = this->mCancelled.load();
+        result.expired = this->mExpired.load();
+        result.failed = this->mFailed.load();
+        result.meanLatency = std::chrono::nanoseconds(result.completed==0 ? 0 :
+                                                      this->mLatencyTotal.load()/result.completed);
+        result.maxLatency = std::chrono::nanoseconds(this->mLatencyMax.load());
+        return result;
+    }
+    void resetStatistics()
+    {
+        this->mSubmitted = 0;
+        this->mCompleted = 0;
+        this->mCancelled = 0;
+        this->mExpired = 0;
+        this->mFailed = 0;
+        this->mLatencyTotal = 0;
+        this->mLatencyMax = 0;
+    }
+private:
+    using Task = std::function<void(Workspace&)>;
+
+    class WorkerQueue
+    {
+    public:
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::mutex mSnapshotMutex;
+    std::shared_ptr<const Snapshot> mSnapshot;
+    const std::size_t mThreadsNumber;
+    std::unique_ptr<WorkerQueue[]> mQueues;
+    std::vector<Workspace> mWorkspaces;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mSleepMutex;
+    std::condition_variable mWakeUp;
+    std::atomic<bool> mStop;
+    std::atomic<std::size_t> mPending;
+    std::atomic<std::size_t> mRunning;
+    std::atomic<std::size_t> mNextQueue;
+
+    std::atomic<std::uint64_t> mSubmitted;
+    std::atomic<std::uint64_t> mCompleted;
+    std::atomic<std::uint64_t> mCancelled;
+    std::atomic<std::uint64_t> mExpired;
+    std::atomic<std::uint64_t> mFailed;
+    std::atomic<std::uint64_t> mLatencyTotal;
+    std::atomic<std::uint64_t> mLatencyMax;
+
+    // indeks wątku puli wykonującego bieżący kod (dla zapytań zgłaszanych z wnętrza zapytań)
+    static std::size_t& mWorkerIndex()
+    {
+        static thread_local std::size_t index = std::numeric_limits<std::size_t>::max();
+        return index;
+    }
+
+    void mPush(Task task)
+    {
+        ++this->mSubmitted;
+        // licznik jest zwiększany przed wstawieniem - wątek budzony za wcześnie najwyżej ponowi próbę
+        ++this->mPending;
+
+        std::size_t queue = mWorkerIndex();
+        if(queue>=this->mThreadsNumber)
+        {
+            queue = this->mNextQueue.fetch_add(1,std::memory_order_relaxed)%this->mThreadsNumber;
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->mQueues[queue].mutex);
+            this->mQueues[queue].tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->mSleepMutex);
+        }
+        this->mWakeUp.notify_one();
+    }
+
+    // bierze zadanie z początku własnej kolejki lub kradnie z końca cudzej
+    bool mTake(std::size_t worker, Task& task)
+    {
+        for(std::size_t k=0;k<this->mThreadsNumber;++k)
+        {
+            WorkerQueue& queue = this->mQueues[(worker+k)%this->mThreadsNumber];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.tasks.empty())continue;
+            if(k==0)
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void mWorker(std::size_t worker)
+    {
+        mWorkerIndex() = worker;
+        Task task;
+        while(true)
+        {
+            if(this->mTake(worker,task))
+            {
+                ++this->mRunning;
+                --this->mPending;
+                task(this->mWorkspaces[worker]);
+                task = nullptr;
+                --this->mRunning;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(this->mSleepMutex);
+            this->mWakeUp.wait(lock,[this]()
+            {
+                return this->mPending.load()>0||this->mStop.load();
+            });
+            if(this->mStop.load()&&this->mPending.load()==0)break;
+        }
+    }
+
+    void mRecordLatency(const QueryState& state)
+    {
+        const std::uint64_t latency = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()-state.submitted).count());
+        this->mLatencyTotal.fetch_add(latency);
+        std::uint64_t current = this->mLatencyMax.load();
+        while(latency>current&&!this->mLatencyMax.compare_exchange_weak(current,latency))
+        {
+
+        }
+        ++this->mCompleted;
+    }
+
+    static void mCheckVertex(const Graph<V, E>& graph, std::size_t vertex_id)
+    {
+        if(vertex_id>=graph.nrOfVertices())
+        {
+            throw std::runtime_error("[Query executor] Incorrect vertex index: "+std::to_string(vertex_id));
+        }
+    }
+
+    // Dijkstra ("heuristics" == nullptr) lub A* z zamykaniem wierzchołków
+    static path_type mSearch(const QueryContext& context, std::size_t start_idx, std::size_t end_idx,
+                             const std::function<double(const E&)>& getEdgeLength,
+                             const std::function<double(const Graph<V, E>&, std::size_t, std::size_t)>& heuristics)
+    {
+        constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+        constexpr std::size_t CHECK_INTERVAL = 256;
+        const Snapshot& snapshot = context.snapshot;
+        const Graph<V, E>& graph = snapshot.graph;
+        mCheckVertex(graph,start_idx);
+        mCheckVertex(graph,end_idx);
+
+        Workspace& ws = context.workspace;
+        ws.reset(graph.nrOfVertices());
+        auto estimate = [&](std::size_t v)
+        {
+            return heuristics ? heuristics(graph,v,end_idx) : 0.;
+        };
+        auto later = [](const std::pair<double, std::size_t>& a, const std::pair<double, std::size_t>& b)
+        {
+            return a.first>b.first;
+        };
+
+        ws.distance[start_idx] = 0;
+        ws.precursor[start_idx] = start_idx;
+        ws.seenStamp[start_idx] = ws.stamp;
+        ws.heap.emplace_back(estimate(start_idx),start_idx);
+
+        for(std::size_t pops=0;!ws.heap.empty();++pops)
+        {
+            if(pops%CHECK_INTERVAL==CHECK_INTERVAL-1)context.check();
+
+            std::pop_heap(ws.heap.begin(),ws.heap.end(),later);
+            const std::size_t vId = ws.heap.back().second;
+            ws.heap.pop_back();
+            if(ws.closed(vId))continue;
+            ws.closedStamp[vId] = ws.stamp;
+
+            if(vId==end_idx)
+            {
+                std::vector<std::size_t> path;
+                for(std::size_t v=end_idx; v!=start_idx; v=ws.precursor[v]) path.push_back(v);
+                path.push_back(start_idx);
+                std::reverse(path.begin(),path.end());
+                return std::make_pair(ws.distance[end_idx],std::move(path));
+            }
+
+            for(std::size_t i=snapshot.offsets[vId];i<snapshot.offsets[vId+1];++i)
+            {
+                const std::size_t x = snapshot.targets[i];
+                if(ws.closed(x))continue;
+                const double newDistance = ws.distance[vId]+getEdgeLength(*snapshot.labels[i]);
+                if(!ws.seen(x)||newDistance<ws.distance[x])
+                {
+                    ws.seenStamp[x] = ws.stamp;
+                    ws.distance[x] = newDistance;
+                    ws.precursor[x] = vId;
+                    ws.heap.emplace_back(newDistance+estimate(x),x);
+                    std::push_heap(ws.heap.begin(),ws.heap.end(),later);
+                }
+            }
+        }
+        return std::make_pair(MAX_DOUBLE_VALUE,std::vector<std::size_t>());
+    }
+
+    static std::vector<std::size_t> mTraversal(const QueryContext& context, std::size_t start_idx, bool breadthFirst)
+    {
+        constexpr std::size_t CHECK_INTERVAL = 256;
+        const Snapshot& snapshot = context.snapshot;
+        mCheckVertex(snapshot.graph,start_idx);
+
+        Workspace& ws = context.workspace;
+        ws.reset(snapshot.graph.nrOfVertices());
+        std::vector<std::size_t> order;
+
+        if(breadthFirst)
+        {
+            ws.seenStamp[start_idx] = ws.stamp;
+            order.push_back(start_idx);
+            for(std::size_t head=0;head<order.size();++head)
+            {
+                if(head%CHECK_INTERVAL==CHECK_INTERVAL-1)context.check();
+                const std::size_t vId = order[head];
+                for(std::size_t i=snapshot.offsets[vId];i<snapshot.offsets[vId+1];++i)
+                {
+                    const std::size_t x = snapshot.targets[i];
+                    if(ws.seen(x))continue;
+                    ws.seenStamp[x] = ws.stamp;
+                    order.push_back(x);
+                }
+            }
+            return order;
+        }
+
+        // stos - sąsiedzi wkładani od końca, więc zdejmowani rosnąco po id
+        ws.list.push_back(start_idx);
+        while(!ws.list.empty())
+        {
+            const std::size_t vId = ws.list.back();
+            ws.list.pop_back();
+            if(ws.seen(vId))continue;
+            ws.seenStamp[vId] = ws.stamp;
+            if(order.size()%CHECK_INTERVAL==CHECK_INTERVAL-1)context.check();
+            order.push_back(vId);
+            for(std::size_t i=snapshot.offsets[vId+1];i-->snapshot.offsets[vId];)
+            {
+                if(!ws.seen(snapshot.targets[i]))ws.list.push_back(snapshot.targets[i]);
+            }
+        }
+        return order;
+    }
+};
@@ -0,0 +1,226 @@
+#pragma once
+#include "Graph.hpp"
+#include "dijkstra.hpp"
+#include "a_star.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// pamięć podręczna wyników "dijkstra()" i "astar()" dla powtarzających się zapytań
+// klucz: (start, koniec, id metryki), wpisy są ważne tylko dla wersji grafu, z której powstały ("Graph::version()")
+// wpisy są rozłożone na niezależne fragmenty (każdy z własnym muteksem), wymiana wpisów algorytmem CLOCK
+// "metricId" musi jednoznacznie identyfikować funkcję długości krawędzi (i heurystykę dla "astar()")
+template<typename V, typename E>
+class ShortestPathCache
+{
+public:
+    using result_type = std::pair<double, std::vector<std::size_t>>;
+
+    ShortestPathCache(const Graph<V, E>& graph, std::size_t capacity = 4096, std::size_t shardsNumber = 16)
+        :mGraph(&graph),
+          mShardsNumber(std::max<std::size_t>(shardsNumber,1)),
+          mShards(new Shard[mShardsNumber]),
+          mHits(0),mMisses(0)
+    {
+        const std::size_t shardCapacity = std::max<std::size_t>(capacity/this->mShardsNumber,1);
+        for(std::size_t i=0;i<this->mShardsNumber;++i)
+        {
+            this->mShards[i].capacity = shardCapacity;
+            this->mShards[i].entries.reserve(shardCapacity);
+        }
+    }
+
+    // zwraca wynik "dijkstra()" z pamięci podręcznej, lub liczy go i zapamiętuje
+    result_type dijkstra(std::size_t start_idx, std::size_t end_idx, std::size_t metricId,
+                         std::function<double(const E&)> getEdgeLength =
+                         [](const E&edge)->double{return edge;})
+    {
+        const Key key{start_idx,end_idx,metricId,false};
+        std::optional<result_type> cached = this->mFind(key);
+        if(cached.has_value())return std::move(cached.value());
+
+        const std::uint64_t version = this->mGraph->version();
+        result_type result = ::dijkstra<V,E>(*this->mGraph,start_idx,end_idx,getEdgeLength);
+        this->mInsert(key,version,result);
+        return result;
+    }
+
+    // zwraca wynik "astar()" z pamięci podręcznej, lub liczy go i zapamiętuje
+    result_type astar(std::size_t start_idx, std::size_t end_idx, std::size_t metricId,
+                      std::function<double(const Graph<V, E>&, std::size_t, std::size_t)> heuristics,
+                      std::function<double(const E&)> getEdgeLength)
+    {
+        const Key key{start_idx,end_idx,metricId,true};
+        std::optional<result_type> cached = this->mFind(key);
+        if(cached.has_value())return std::move(cached.value());
+
+        const std::uint64_t version = this->mGraph->version();
+        result_type result = ::astar<V,E>(*this->mGraph,start_idx,end_idx,heuristics,getEdgeLength);
+        this->mInsert(key,version,result);
+        return result;
+    }
+
+    // usuwa wszystkie wpisy
+    void clear()
+    {
+        for(std::size_t i=0;i<this->mShardsNumber;++i)
+        {
+            Shard& shard = this->mShards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.entries.clear();
+            shard.hand = 0;
+        }
+    }
+
+    // zwraca liczbę zapamiętanych wpisów (również nieaktualnych)
+    std::size_t size() const
+    {
+        std::size_t result = 0;
+        for(std::size_t i=0;i<this->mShardsNumber;++i)
+        {
+            std::lock_guard<std::mutex> lock(this->mShards[i].mutex);
+            result += this->mShards[i].index.size();
+        }
+        return result;
+    }
+
+    std::uint64_t hits() const
+    {
+        return this->mHits.load(std::memory_order_relaxed);
+    }
+    std::uint64_t misses() const
+    {
+        return this->mMisses.load(std::memory_order_relaxed);
+    }
+    // zwraca stosunek trafień do wszystkich zapytań (0 gdy nie było zapytań)
+    double hitRate() const
+    {
+        std::uint64_t h = this->hits();
+        std::uint64_t all = h+this->misses();
+        return all==0 ? 0. : static_cast<double>(h)/static_cast<double>(all);
+    }
+    void resetStatistics()
+    {
+        this->mHits = 0;
+        this->mMisses = 0;
+    }
+private:
+    class Key
+    {
+    public:
+        std::size_t start;
+        std::size_t end;
+        std::size_t metric;
+        bool heuristic;
+
+        bool operator==(const Key& k) const
+        {
+            return this->start==k.start&&this->end==k.end
+                    &&this->metric==k.metric&&this->heuristic==k.heuristic;
+        }
+    };
+    class KeyHash
+    {
+    public:
+        std::size_t operator()(const Key& k) const
+        {
+            std::uint64_t h = k.start*0x9E3779B97F4A7C15ull;
+            h ^= k.end+0x7F4A7C159E3779B9ull+(h<<6)+(h>>2);
+            h ^= k.metric+0x94D049BB133111EBull+(h<<6)+(h>>2);
+            return static_cast<std::size_t>(h^(k.heuristic ? 0xBF58476D1CE4E5B9ull : 0));
+        }
+    };
+    class Entry
+    {
+    public:
+        Key key;
+        std::uint64_t version;
+        bool referenced;
+        result_type result;
+    };
+    class Shard
+    {
+    public:
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::size_t, KeyHash> index;
+        std::vector<Entry> entries;
+        std::size_t capacity = 1;
+        std::size_t hand = 0;
+    };
+
+    const Graph<V, E>* mGraph;
+    std::size_t mShardsNumber;
+    std::unique_ptr<Shard[]> mShards;
+    std::atomic<std::uint64_t> mHits;
+    std::atomic<std::uint64_t> mMisses;
+
+    Shard& mShard(const Key& key)
+    {
+        return this->mShards[KeyHash()(key)%this->mShardsNumber];
+    }
+
+    std::optional<result_type> mFind(const Key& key)
+    {
+        Shard& shard = this->mShard(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if(it!=shard.index.end())
+            {
+                Entry& entry = shard.entries[it->second];
+                if(entry.version==this->mGraph->version())
+                {
+                    entry.referenced = true;
+                    this->mHits.fetch_add(1,std::memory_order_relaxed);
+                    return entry.result;
+                }
+            }
+        }
+        this->mMisses.fetch_add(1,std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    void mInsert(const Key& key, std::uint64_t version, const result_type& result)
+    {
+        Shard& shard = this->mShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if(it!=shard.index.end())
+        {
+            Entry& entry = shard.entries[it->second];
+            entry.version = version;
+            entry.referenced = true;
+            entry.result = result;
+            return;
+        }
+
+        if(shard.entries.size()<shard.capacity)
+        {
+            shard.index.emplace(key,shard.entries.size());
+            shard.entries.push_back(Entry{key,version,false,result});
+            return;
+        }
+
+        // CLOCK: pomija (i zeruje bit) wpisy używane od ostatniego obiegu wskazówki,
+        // nieaktualne wpisy są wymieniane od razu
+        const std::uint64_t currentVersion = this->mGraph->version();
+        while(true)
+        {
+            Entry& entry = shard.entries[shard.hand];
+            if(!entry.referenced||entry.version!=currentVersion)break;
+            entry.referenced = false;
+            shard.hand = (shard.hand+1)%shard.capacity;
+        }
+
+        Entry& victim = shard.entries[shard.hand];
+        shard.index.erase(victim.key);
+        victim = Entry{key,version,false,result};
+        shard.index.emplace(key,shard.hand);
+        shard.hand = (shard.hand+1)%shard.capacity;
+    }
+};
@@ -0,0 +1,418 @@
+#pragma once
+#include "Graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+// indeks przestrzenny wierzchołków o współrzędnych 2D ("getCoordinates(vertexData)")
+// siatka kubełków (kubełek = kwadrat o boku "cellSize") przechowywana w tablicy haszującej,
+// wpisy kubełka trzymają współrzędne razem z id, więc zapytania nie sięgają do grafu
+// indeks jest aktualizowany z dziennika zmian grafu ("Graph::changesSince()") przy każdym zapytaniu
+// bok kubełka jest dobierany ponownie, gdy liczba wierzchołków zmieni się kilkukrotnie
+template<typename V, typename E>
+class SpatialIndex
+{
+public:
+    using point_type = std::pair<double, double>;
+
+    // "cellSize" == 0 - bok kubełka dobierany automatycznie (średnio ok. 2 wierzchołki na kubełek)
+    SpatialIndex(Graph<V, E>& graph,
+                 std::function<point_type(const V&)> getCoordinates = [](const V& vertex)->point_type
+                 {
+                     return point_type(static_cast<double>(vertex.first),static_cast<double>(vertex.second));
+                 },
+                 double cellSize = 0., std::size_t journalCapacity = 4096)
+        :mGraph(&graph),mGetCoordinates(getCoordinates),mVersion(graph.version()),
+          mFixedCellSize(cellSize),mSize(0)
+    {
+        if(cellSize<0.||!std::isfinite(cellSize))
+        {
+            throw std::runtime_error("[Spatial index] Incorrect cell size: "+std::to_string(cellSize));
+        }
+        if(graph.changeJournalCapacity()<journalCapacity)
+        {
+            graph.enableChangeJournal(journalCapacity);
+        }
+        this->mRebuild();
+    }
+
+    // zwraca id wierzchołka najbliższego punktowi (x, y), lub std::nullopt dla pustego grafu
+    std::optional<std::size_t> nearestVertex(double x, double y)
+    {
+        this->update();
+        return this->mNearest(x,y);
+    }
+
+    // zwraca id "k" wierzchołków najbliższych punktowi (x, y), od najbliższego
+    std::vector<std::size_t> kNearestVertices(double x, double y, std::size_t k)
+    {
+        this->update();
+        return this->mKNearest(x,y,k);
+    }
+
+    // zwraca id wierzchołków w odległości co najwyżej "radius" od punktu (x, y), rosnąco
+    std::vector<std::size_t> verticesWithinRadius(double x, double y, double radius);
+
+    // przyciąga każdy z punktów do najbliższego wierzchołka (równolegle, "threadsNumber" == 0 - liczba rdzeni)
+    std::vector<std::optional<std::size_t>> snap(const std::vector<point_type>& points,
+                                                 std::size_t threadsNumber = 0)
+    {
+        this->update();
+        std::vector<std::optional<std::size_t>> result(points.size());
+        parallelFor(0,points.size(),[&](std::size_t i)
+        {
+            result[i] = this->mNearest(points[i].first,points[i].second);
+        },threadsNumber,256);
+        return result;
+    }
+
+    // przetwarza zmiany grafu od ostatniej aktualizacji
+    void update();
+
+    // zwraca liczbę zaindeksowanych wierzchołków
+    std::size_t size()
+    {
+        this->update();
+        return this->mSize;
+    }
+    double cellSize() const
+    {
+        return this->mCellSize;
+    }
+private:
+    class Entry
+    {
+    public:
+        double x;
+        double y;
+        std::size_t id;
+    };
+
+    Graph<V, E>* mGraph;
+    std::function<point_type(const V&)> mGetCoordinates;
+    std::uint64_t mVersion;
+    double mFixedCellSize;
+    double mCellSize;
+    // liczba wierzchołków, dla której dobrano bok kubełka
+    std::size_t mSizeAtBuild;
+
+    // współrzędne każdego wierzchołka (std::nullopt - wierzchołek jeszcze nie zaindeksowany)
+    std::vector<std::optional<point_type>> mPoints;
+    std::unordered_map<std::uint64_t, std::vector<Entry>> mCells;
+    std::size_t mSize;
+    // zakres zajętych kubełków (może być szerszy niż rzeczywisty po usunięciach)
+    std::int64_t mMinCellX, mMinCellY, mMaxCellX, mMaxCellY;
+
+    std::int64_t mCellCoordinate(double c) const
+    {
+        return static_cast<std::int64_t>(std::floor(c/this->mCellSize));
+    }
+    static std::uint64_t mCellKey(std::int64_t cx, std::int64_t cy)
+    {
+        return (static_cast<std::uint64_t>(cx)<<32)^(static_cast<std::uint64_t>(cy)&0xFFFFFFFFull);
+    }
+    const std::vector<Entry>* mCell(std::int64_t cx, std::int64_t cy) const
+    {
+        auto it = this->mCells.find(mCellKey(cx,cy));
+        return it==this->mCells.end() ? nullptr : &it->second;
+    }
+
+    std::optional<std::size_t> mNearest(double x, double y) const
+    {
+        std::vector<std::size_t> result = this->mKNearest(x,y,1);
+        if(result.empty())return std::nullopt;
+        return result.front();
+    }
+    std::vector<std::size_t> mKNearest(double x, double y, std::size_t k) const;
+
+    void mRebuild();
+    void mInsert(std::size_t vertex_id);
+    void mErase(std::size_t vertex_id);
+};
+
+// przegląda kubełki pierścieniami wokół kubełka punktu, do momentu gdy najbliższy nieodwiedzony
+// pierścień jest dalej niż k-ty najlepszy kandydat
+template<typename V, typename E>
+std::vector<std::size_t> SpatialIndex<V,E>::mKNearest(double x, double y, std::size_t k) const
+{
+    std::vector<std::size_t> result;
+    k = std::min(k,this->mSize);
+    if(k==0)return result;
+
+    // kopiec z największą odległością na szczycie
+    using Candidate = std::pair<double, std::size_t>;
+    std::priority_queue<Candidate> best;
+
+    auto visitCell = [&](const std::vector<Entry>& cell)
+    {
+        for(const Entry& entry: cell)
+        {
+            double d = (entry.x-x)*(entry.x-x)+(entry.y-y)*(entry.y-y);
+            if(best.size()<k)best.emplace(d,entry.id);
+            else if(Candidate(d,entry.id)<best.top())
+            {
+                best.pop();
+                best.emplace(d,entry.id);
+            }
+        }
+    };
+    auto visit = [&](std::int64_t cx, std::int64_t cy)
+    {
+        const std::vector<Entry>* cell = this->mCell(cx,cy);
+        if(cell!=nullptr)visitCell(*cell);
+    };
+
+    const std::int64_t qx = this->mCellCoordinate(x);
+    const std::int64_t qy = this->mCellCoordinate(y);
+    // pierścień, od którego wszystkie zajęte kubełki zostały już odwiedzone
+    const std::int64_t lastRing = std::max(std::max(qx-this->mMinCellX,this->mMaxCellX-qx),
+                                           std::max(qy-this->mMinCellY,this->mMaxCellY-qy));
+
+    visit(qx,qy);
+    for(std::int64_t r=1;r<=lastRing;++r)
+    {
+        // daleko od zajętych kubełków (lub dla rozrzuconych punktów) taniej przejrzeć wszystkie kubełki
+        if(static_cast<std::size_t>(8*r)>this->mCells.size())
+        {
+            best = std::priority_queue<Candidate>();
+            for(const auto& cell: this->mCells) visitCell(cell.second);
+            break;
+        }
+
+        for(std::int64_t i=-r;i<=r;++i)
+        {
+            visit(qx+i,qy-r);
+            visit(qx+i,qy+r);
+        }
+        for(std::int64_t i=-r+1;i<=r-1;++i)
+        {
+            visit(qx-r,qy+i);
+            visit(qx+r,qy+i);
+        }
+
+        if(best.size()==k)
+        {
+            // najmniejsza odległość punktu od kubełków spoza pierścienia "r"
+            double border = std::min(std::min(x-static_cast<double>(qx-r)*this->mCellSize,
+                                              static_cast<double>(qx+r+1)*this->mCellSize-x),
+                                     std::min(y-static_cast<double>(qy-r)*this->mCellSize,
+                                              static_cast<double>(qy+r+1)*this->mCellSize-y));
+            if(best.top().first<=border*border)break;
+        }
+    }
+
+    result.resize(best.size());
+    for(std::size_t i=result.size();i>0;--i)
+    {
+        result[i-1] = best.top().second;
+        best.pop();
+    }
+    return result;
+}
+
+template<typename V, typename E>
+std::vector<std::size_t> SpatialIndex<V,E>::verticesWithinRadius(double x, double y, double radius)
+{
+    this->update();
+
+    std::vector<std::size_t> result;
+    if(radius<0.||this->mSize==0)return result;
+
+    const double r2 = radius*radius;
+    auto visit = [&](const std::vector<Entry>& cell)
+    {
+        for(const Entry& entry: cell)
+        {
+            if((entry.x-x)*(entry.x-x)+(entry.y-y)*(entry.y-y)<=r2)result.push_back(entry.id);
+        }
+    };
+
+    const std::int64_t x1 = std::max(this->mCellCoordinate(x-radius),this->mMinCellX);
+    const std::int64_t x2 = std::min(this->mCellCoordinate(x+radius),this->mMaxCellX);
+    const std::int64_t y1 = std::max(this->mCellCoordinate(y-radius),this->mMinCellY);
+    const std::int64_t y2 = std::min(this->mCellCoordinate(y+radius),this->mMaxCellY);
+
+    if(x1<=x2&&y1<=y2)
+    {
+        // przy dużym promieniu taniej przejrzeć wszystkie zajęte kubełki
+        if(static_cast<double>(x2-x1+1)*static_cast<double>(y2-y1+1)>static_cast<double>(this->mCells.size()))
+        {
+            for(const auto& cell: this->mCells) visit(cell.second);
+        }
+        else
+        {
+            for(std::int64_t cy=y1;cy<=y2;++cy)
+            {
+                for(std::int64_t cx=x1;cx<=x2;++cx)
+                {
+                    const std::vector<Entry>* cell = this->mCell(cx,cy);
+                    if(cell!=nullptr)visit(*cell);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(),result.end());
+    return result;
+}
+
+template<typename V, typename E>
+void SpatialIndex<V,E>::mRebuild()
+{
+    const Graph<V, E>& graph = *this->mGraph;
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    this->mPoints.assign(verticesNumber,std::nullopt);
+    this->mCells.clear();
+    this->mSize = 0;
+    this->mSizeAtBuild = verticesNumber;
+    this->mMinCellX = this->mMinCellY = std::numeric_limits<std::int64_t>::max();
+    this->mMaxCellX = this->mMaxCellY = std::numeric_limits<std::int64_t>::min();
+
+    this->mCellSize = this->mFixedCellSize;
+    if(this->mCellSize==0.)
+    {
+        double minX = std::numeric_limits<double>::max(), maxX = std::numeric_limits<double>::lowest();
+        double minY = minX, maxY = maxX;
+        for(std::size_t i=0;i<verticesNumber;++i)
+        {
+            point_type p = this->mGetCoordinates(graph.vertexData(i));
+            minX = std::min(minX,p.first);
+            maxX = std::max(maxX,p.first);
+            minY = std::min(minY,p.second);
+            maxY = std::max(maxY,p.second);
+        }
+        double area = verticesNumber>1 ? std::max(maxX-minX,0.)*std::max(maxY-minY,0.) : 0.;
+        double side = verticesNumber>1 ? std::max(maxX-minX,maxY-minY) : 0.;
+        // dla punktów na prostej powierzchnia jest zerowa - kubełki wzdłuż dłuższego boku
+        this->mCellSize = area>0. ? std::sqrt(2.*area/static_cast<double>(verticesNumber))
+                                  : 2.*side/static_cast<double>(std::max<std::size_t>(verticesNumber,1));
+        if(!(this->mCellSize>0.)||!std::isfinite(this->mCellSize))this->mCellSize = 1.;
+    }
+
+    for(std::size_t i=0;i<verticesNumber;++i)
+    {
+        this->mInsert(i);
+    }
+}
+
+// indeksuje wierzchołek o podanym id z aktualnymi danymi z grafu
+template<typename V, typename E>
+void SpatialIndex<V,E>::mInsert(std::size_t vertex_id)
+{
+    const Graph<V, E>& graph = *this->mGraph;
+    point_type p = this->mGetCoordinates(graph.vertexData(vertex_id));
+    if(!std::isfinite(p.first)||!std::isfinite(p.second))
+    {
+        throw std::runtime_error("[Spatial index] Incorrect coordinates of vertex: "+std::to_string(vertex_id));
+    }
+    this->mPoints[vertex_id] = p;
+
+    const std::int64_t cx = this->mCellCoordinate(p.first);
+    const std::int64_t cy = this->mCellCoordinate(p.second);
+    this->mCells[mCellKey(cx,cy)].push_back(Entry{p.first,p.second,vertex_id});
+    this->mMinCellX = std::min(this->mMinCellX,cx);
+    this->mMaxCellX = std::max(this->mMaxCellX,cx);
+    this->mMinCellY = std::min(this->mMinCellY,cy);
+    this->mMaxCellY = std::max(this->mMaxCellY,cy);
+    ++this->mSize;
+}
+
+template<typename V, typename E>
+void SpatialIndex<V,E>::mErase(std::size_t vertex_id)
+{
+    if(!this->mPoints[vertex_id].has_value())return;
+
+    const point_type& p = this->mPoints[vertex_id].value();
+    auto it = this->mCells.find(mCellKey(this->mCellCoordinate(p.first),this->mCellCoordinate(p.second)));
+    std::vector<Entry>& cell = it->second;
+    for(std::size_t i=0;i<cell.size();++i)
+    {
+        if(cell[i].id==vertex_id)
+        {
+            cell[i] = cell.back();
+            cell.pop_back();
+            break;
+        }
+    }
+    if(cell.empty())this->mCells.erase(it);
+
+    this->mPoints[vertex_id].reset();
+    --this->mSize;
+}
+
+template<typename V, typename E>
+void SpatialIndex<V,E>::update()
+{
+    if(this->mVersion==this->mGraph->version())return;
+
+    using Change = typename Graph<V, E>::Change;
+    std::optional<std::vector<Change>> changes = this->mGraph->changesSince(this->mVersion);
+    this->mVersion = this->mGraph->version();
+
+    const std::size_t verticesNumber = this->mGraph->nrOfVertices();
+    if(!changes.has_value() ||
+            (this->mFixedCellSize==0. &&
+             (verticesNumber>4*std::max<std::size_t>(this->mSizeAtBuild,16) || 4*verticesNumber<this->mSizeAtBuild)))
+    {
+        this->mRebuild();
+        return;
+    }
+
+    // zmiany są odtwarzane na współrzędnych i id, a zmienione wierzchołki są indeksowane na końcu
+    // z aktualnymi danymi (po wszystkich przesunięciach id)
+    std::vector<std::size_t> pending;
+    for(const Change& c: changes.value())
+    {
+        if(c.kind==Change::VertexInserted)
+        {
+            this->mPoints.emplace_back();
+            pending.push_back(c.y);
+        }
+        else if(c.kind==Change::VertexChanged)
+        {
+            this->mErase(c.y);
+            pending.push_back(c.y);
+        }
+        else if(c.kind==Change::VertexRemoved)
+        {
+            this->mErase(c.y);
+            this->mPoints.erase(this->mPoints.begin()+c.y);
+            for(auto& cell: this->mCells)
+            {
+                for(Entry& entry: cell.second)
+                {
+                    if(entry.id>c.y) --entry.id;
+                }
+            }
+
+            std::size_t kept = 0;
+            for(std::size_t id: pending)
+            {
+                if(id!=c.y) pending[kept++] = id>c.y ? id-1 : id;
+            }
+            pending.resize(kept);
+        }
+        else if(c.kind==Change::Cleared)
+        {
+            this->mPoints.clear();
+            this->mCells.clear();
+            this->mSize = 0;
+            this->mMinCellX = this->mMinCellY = std::numeric_limits<std::int64_t>::max();
+            this->mMaxCellX = this->mMaxCellY = std::numeric_limits<std::int64_t>::min();
+            pending.clear();
+        }
+    }
+
+    for(std::size_t id: pending)
+    {
+        if(!this->mPoints[id].has_value())this->mInsert(id);
+    }
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include "Graph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+
+// funkcja skrótu dla kluczy indeksu - std::hash, oraz połączenie skrótów dla std::pair
+template<typename Key>
+class VertexKeyHash: public std::hash<Key>
+{
+
+};
+template<typename A, typename B>
+class VertexKeyHash<std::pair<A, B>>
+{
+public:
+    std::size_t operator()(const std::pair<A, B>& key) const
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(VertexKeyHash<A>()(key.first))*0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h^(VertexKeyHash<B>()(key.second)+0x7F4A7C159E3779B9ull+(h<<6)+(h>>2)));
+    }
+};
+
+// indeks haszujący: klucz wierzchołka ("getKey(vertexData)") -> id wierzchołka
+// adresowanie otwarte z sondowaniem liniowym i usuwaniem przez przesuwanie wpisów (bez "nagrobków")
+// indeks jest aktualizowany z dziennika zmian grafu ("Graph::changesSince()") przy każdym zapytaniu,
+// więc pozostaje zgodny po "insertVertex()", "removeVertex()" (przesunięcie id), "vertexData()", iteratorach grafu i "clear()"
+// przepełnienie dziennika powoduje przebudowanie indeksu
+template<typename V, typename E, typename Key = V, typename Hash = VertexKeyHash<Key>>
+class VertexIndex
+{
+public:
+    VertexIndex(Graph<V, E>& graph,
+                std::function<Key(const V&)> getKey = [](const V& vertex)->Key{return vertex;},
+                std::size_t journalCapacity = 4096)
+        :mGraph(&graph),mGetKey(getKey),mVersion(graph.version()),mSize(0)
+    {
+        if(graph.changeJournalCapacity()<journalCapacity)
+        {
+            graph.enableChangeJournal(journalCapacity);
+        }
+        this->mRebuild();
+    }
+
+    // zwraca id wierzchołka o podanym kluczu (najmniejsze, jeśli jest ich kilka), lub std::nullopt
+    // O(1) (oczekiwanie)
+    std::optional<std::size_t> findVertex(const Key& key)
+    {
+        this->update();
+
+        std::optional<std::size_t> result;
+        for(std::size_t slot = this->mHome(key); this->mSlots[slot]!=EMPTY; slot = this->mNext(slot))
+        {
+            std::size_t id = this->mSlots[slot];
+            if((!result.has_value()||id<result.value()) && this->mKeys[id].value()==key)
+            {
+                result = id;
+            }
+        }
+        return result;
+    }
+
+    // zwraca id wszystkich wierzchołków o podanym kluczu (rosnąco)
+    std::vector<std::size_t> findVertices(const Key& key)
+    {
+        this->update();
+
+        std::vector<std::size_t> result;
+        for(std::size_t slot = this->mHome(key); this->mSlots[slot]!=EMPTY; slot = this->mNext(slot))
+        {
+            std::size_t id = this->mSlots[slot];
+            if(this->mKeys[id].value()==key)result.push_back(id);
+        }
+        std::sort(result.begin(),result.end());
+        return result;
+    }
+
+    // przetwarza zmiany grafu od ostatniej aktualizacji
+    void update();
+
+    // zwraca liczbę zaindeksowanych wierzchołków
+    std::size_t size()
+    {
+        this->update();
+        return this->mSize;
+    }
+private:
+    static constexpr std::size_t EMPTY = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    Graph<V, E>* mGraph;
+    std::function<Key(const V&)> mGetKey;
+    Hash mHash;
+    std::uint64_t mVersion;
+
+    // klucz każdego wierzchołka (std::nullopt - wierzchołek jeszcze nie zaindeksowany)
+    std::vector<std::optional<Key>> mKeys;
+    // id wierzchołków, rozmiar jest potęgą dwójki, wypełnienie najwyżej 1/2
+    std::vector<std::size_t> mSlots;
+    std::size_t mSize;
+
+    std::size_t mHome(const Key& key) const
+    {
+        // mieszanie (splitmix64) - std::hash dla liczb całkowitych to zwykle identyczność
+        std::uint64_t h = static_cast<std::uint64_t>(this->mHash(key));
+        h = (h^(h>>30))*0xBF58476D1CE4E5B9ull;
+        h = (h^(h>>27))*0x94D049BB133111EBull;
+        h ^= h>>31;
+        return static_cast<std::size_t>(h)&(this->mSlots.size()-1);
+    }
+    std::size_t mNext(std::size_t slot) const
+    {
+        return (slot+1)&(this->mSlots.size()-1);
+    }
+
+    void mRebuild();
+    void mResize(std::size_t capacity);
+    void mInsert(std::size_t vertex_id);
+    void mErase(std::size_t vertex_id);
+};
+
+template<typename V, typename E, typename Key, typename Hash>
+void VertexIndex<V,E,Key,Hash>::mRebuild()
+{
+    const std::size_t verticesNumber = this->mGraph->nrOfVertices();
+    this->mKeys.assign(verticesNumber,std::nullopt);
+    this->mSize = 0;
+
+    std::size_t capacity = MIN_CAPACITY;
+    while(capacity<2*verticesNumber) capacity *= 2;
+    this->mSlots.assign(capacity,EMPTY);
+
+    for(std::size_t i=0;i<verticesNumber;++i)
+    {
+        this->mInsert(i);
+    }
+}
+
+template<typename V, typename E, typename Key, typename Hash>
+void VertexIndex<V,E,Key,Hash>::mResize(std::size_t capacity)
+{
+    std::vector<std::size_t> previous(capacity,EMPTY);
+    previous.swap(this->mSlots);
+    for(std::size_t id: previous)
+    {
+        if(id==EMPTY)continue;
+        std::size_t slot = this->mHome(this->mKeys[id].value());
+        while(this->mSlots[slot]!=EMPTY) slot = this->mNext(slot);
+        this->mSlots[slot] = id;
+    }
+}
+
+// indeksuje wierzchołek o podanym id z aktualnymi danymi z grafu
+template<typename V, typename E, typename Key, typename Hash>
+void VertexIndex<V,E,Key,Hash>::mInsert(std::size_t vertex_id)
+{
+    if(2*(this->mSize+1)>this->mSlots.size())
+    {
+        this->mResize(2*this->mSlots.size());
+    }
+
+    const Graph<V, E>& graph = *this->mGraph;
+    this->mKeys[vertex_id] = this->mGetKey(graph.vertexData(vertex_id));
+
+    std::size_t slot = this->mHome(this->mKeys[vertex_id].value());
+    while(this->mSlots[slot]!=EMPTY) slot = this->mNext(slot);
+    this->mSlots[slot] = vertex_id;
+    ++this->mSize;
+}
+
+// usuwa wierzchołek z tablicy, kolejne wpisy łańcucha są przesuwane w zwolnione miejsce
+template<typename V, typename E, typename Key, typename Hash>
+void VertexIndex<V,E,Key,Hash>::mErase(std::size_t vertex_id)
+{
+    if(!this->mKeys[vertex_id].has_value())return;
+
+    std::size_t slot = this->mHome(this->mKeys[vertex_id].value());
+    while(this->mSlots[slot]!=vertex_id) slot = this->mNext(slot);
+
+    const std::size_t mask = this->mSlots.size()-1;
+    std::size_t hole = slot;
+    for(std::size_t next = this->mNext(hole); this->mSlots[next]!=EMPTY; next = this->mNext(next))
+    {
+        std::size_t home = this->mHome(this->mKeys[this->mSlots[next]].value());
+        // wpis może zająć dziurę, jeśli jego pozycja domowa nie leży cyklicznie w (hole, next]
+        if(((next-home)&mask)>=((next-hole)&mask))
+        {
+            this->mSlots[hole] = this->mSlots[next];
+            hole = next;
+        }
+    }
+    this->mSlots[hole] = EMPTY;
+    this->mKeys[vertex_id].reset();
+    --this->mSize;
+}
+
+template<typename V, typename E, typename Key, typename Hash>
+void VertexIndex<V,E,Key,Hash>::update()
+{
+    if(this->mVersion==this->mGraph->version())return;
+
+    using Change = typename Graph<V, E>::Change;
+    std::optional<std::vector<Change>> changes = this->mGraph->changesSince(this->mVersion);
+    this->mVersion = this->mGraph->version();
+
+    if(!changes.has_value())
+    {
+        this->mRebuild();
+        return;
+    }
+
+    // zmiany są odtwarzane na kluczach i id, a zmienione wierzchołki są indeksowane na końcu
+    // z aktualnymi danymi (po wszystkich przesunięciach id)
+    std::vector<std::size_t> pending;
+    for(const Change& c: changes.value())
+    {
+        if(c.kind==Change::VertexInserted)
+        {
+            this->mKeys.emplace_back();
+            pending.push_back(c.y);
+        }
+        else if(c.kind==Change::VertexChanged)
+        {
+            this->mErase(c.y);
+            pending.push_back(c.y);
+        }
+        else if(c.kind==Change::VertexRemoved)
+        {
+            this->mErase(c.y);
+            this->mKeys.erase(this->mKeys.begin()+c.y);
+            for(std::size_t& id: this->mSlots)
+            {
+                if(id!=EMPTY&&id>c.y) --id;
+            }
+
+            std::size_t kept = 0;
+            for(std::size_t id: pending)
+            {
+                if(id!=c.y) pending[kept++] = id>c.y ? id-1 : id;
+            }
+            pending.resize(kept);
+        }
+        else if(c.kind==Change::Cleared)
+        {
+            this->mKeys.clear();
+            this->mSlots.assign(MIN_CAPACITY,EMPTY);
+            this->mSize = 0;
+            pending.clear();
+        }
+    }
+
+    for(std::size_t id: pending)
+    {
+        if(!this->mKeys[id].has_value())this->mInsert(id);
+    }
+}
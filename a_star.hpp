@@ -1,19 +1,23 @@
 #pragma once
 #include "Graph.hpp"
+#include "tracing.hpp"
 #include <functional>
 #include <limits>
 #include <optional>
 #include <algorithm>
 #include <set>
 #include <map>
+#include <memory_resource>
 
+// "scratchResource" - zasób pamięci na zbiory i tablice robocze szukania
 template<typename V, typename E>
 std::pair<double, std::vector<std::size_t>>
-astar(Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx,
+astar(const Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx,
       std::function<double(const Graph<V, E>&, std::size_t actual_vertex_id, std::size_t end_vertex_id)>
-      heuristics, std::function<double(const E&)> getEdgeLength = nullptr)
+      heuristics, std::function<double(const E&)> getEdgeLength = nullptr,
+      std::pmr::memory_resource* scratchResource = std::pmr::get_default_resource())
 {
-
+    GRAPH_TRACE_SPAN(span,"query","astar: setup");
     constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
     const std::size_t verticesNumber = graph.nrOfVertices();
 
@@ -25,16 +29,17 @@ astar(Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx,
     }
 
 
-    std::set<std::size_t> openSet;
+    std::pmr::set<std::size_t> openSet(scratchResource);
     openSet.insert(start_idx);
 
-    std::map<std::size_t,std::size_t> cameFrom;
+    std::pmr::map<std::size_t,std::size_t> cameFrom(scratchResource);
 
-    std::vector<double> gScore(verticesNumber, MAX_DOUBLE_VALUE);
+    std::pmr::vector<double> gScore(verticesNumber, MAX_DOUBLE_VALUE, scratchResource);
     gScore[start_idx] = 0;
-    std::vector<double> fScore(verticesNumber, MAX_DOUBLE_VALUE);
+    std::pmr::vector<double> fScore(verticesNumber, MAX_DOUBLE_VALUE, scratchResource);
     fScore[start_idx] = heuristics(graph, start_idx, end_idx);
 
+    GRAPH_TRACE_NEXT(span,"astar: search");
     while(!openSet.empty())
     {
         std::size_t current_node = verticesNumber;
@@ -51,6 +56,7 @@ astar(Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx,
 
         if(current_node == end_idx)
         {
+            GRAPH_TRACE_NEXT(span,"astar: path reconstruction");
             std::vector<std::size_t> path;
             path.push_back(current_node);
             while(current_node!=start_idx)
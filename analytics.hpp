@@ -0,0 +1,394 @@
+#pragma once
+#include "Graph.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(GRAPH_SIMD_AVX2)
+// iloczyn skalarny początku wiersza macierzy rzadkiej z wektorem "x", po 4 / 8 kolumn naraz (gather)
+// "i" to liczba przetworzonych kolumn
+inline GRAPH_SIMD_TARGET("avx2") double sparseRowDotAvx2(const double* values, const std::uint32_t* columns,
+                                                         const double* x, std::size_t n, std::size_t& i)
+{
+    __m256d sum = _mm256_setzero_pd();
+    for(i=0;i+4<=n;i+=4)
+    {
+        __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns+i));
+        sum = _mm256_add_pd(sum,_mm256_mul_pd(_mm256_loadu_pd(values+i),_mm256_i32gather_pd(x,index,8)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes,sum);
+    return (lanes[0]+lanes[1])+(lanes[2]+lanes[3]);
+}
+
+inline GRAPH_SIMD_TARGET("avx2") float sparseRowDotAvx2(const float* values, const std::uint32_t* columns,
+                                                        const float* x, std::size_t n, std::size_t& i)
+{
+    __m256 sum = _mm256_setzero_ps();
+    for(i=0;i+8<=n;i+=8)
+    {
+        __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns+i));
+        sum = _mm256_add_ps(sum,_mm256_mul_ps(_mm256_loadu_ps(values+i),_mm256_i32gather_ps(x,index,4)));
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes,sum);
+    return ((lanes[0]+lanes[1])+(lanes[2]+lanes[3]))+((lanes[4]+lanes[5])+(lanes[6]+lanes[7]));
+}
+#endif
+
+// iloczyn skalarny wiersza macierzy rzadkiej (wartości, kolumny) z wektorem "x"
+inline double sparseRowDot(const double* values, const std::uint32_t* columns, const double* x, std::size_t n)
+{
+    std::size_t i = 0;
+    double result = 0;
+#if defined(GRAPH_SIMD_AVX2)
+    if(cpuSupportsAvx2()) result = sparseRowDotAvx2(values,columns,x,n,i);
+    else
+#endif
+    {
+        double sum[4] = {0,0,0,0};
+        for(;i+4<=n;i+=4)
+        {
+            sum[0] += values[i]*x[columns[i]];
+            sum[1] += values[i+1]*x[columns[i+1]];
+            sum[2] += values[i+2]*x[columns[i+2]];
+            sum[3] += values[i+3]*x[columns[i+3]];
+        }
+        result = (sum[0]+sum[1])+(sum[2]+sum[3]);
+    }
+    for(;i<n;++i)
+    {
+        result += values[i]*x[columns[i]];
+    }
+    return result;
+}
+
+inline float sparseRowDot(const float* values, const std::uint32_t* columns, const float* x, std::size_t n)
+{
+    std::size_t i = 0;
+    float result = 0;
+#if defined(GRAPH_SIMD_AVX2)
+    if(cpuSupportsAvx2()) result = sparseRowDotAvx2(values,columns,x,n,i);
+    else
+#endif
+    {
+        float sum[4] = {0,0,0,0};
+        for(;i+4<=n;i+=4)
+        {
+            sum[0] += values[i]*x[columns[i]];
+            sum[1] += values[i+1]*x[columns[i+1]];
+            sum[2] += values[i+2]*x[columns[i+2]];
+            sum[3] += values[i+3]*x[columns[i+3]];
+        }
+        result = (sum[0]+sum[1])+(sum[2]+sum[3]);
+    }
+    for(;i<n;++i)
+    {
+        result += values[i]*x[columns[i]];
+    }
+    return result;
+}
+
+// macierz rzadka (CSR) zbudowana z krawędzi grafu: A[y][x] = getEdgeWeight(krawędź y->x)
+// "transposed" - A[x][y] (wiersz wierzchołka zawiera jego krawędzie wchodzące)
+// "getEdgeWeight" == nullptr - waga każdej krawędzi równa 1
+// T - double lub float
+template<typename T = double>
+class SparseMatrix
+{
+    static_assert(std::is_same<T,double>::value||std::is_same<T,float>::value,
+                  "SparseMatrix supports only double and float");
+public:
+    template<typename V, typename E>
+    SparseMatrix(const Graph<V, E>& graph,
+                 std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeWeight = nullptr,
+                 bool transposed = false);
+
+    std::size_t rows() const
+    {
+        return this->mOffsets.size()-1;
+    }
+    std::size_t nonZeros() const
+    {
+        return this->mColumns.size();
+    }
+
+    // y = A*x, wiersze są rozdzielane między wątki ("threadsNumber" == 0 - liczba rdzeni)
+    void multiply(const T* x, T* y, std::size_t threadsNumber = 0) const
+    {
+        parallelFor(0,this->rows(),[&](std::size_t row)
+        {
+            y[row] = sparseRowDot(this->mValues.data()+this->mOffsets[row],
+                                  this->mColumns.data()+this->mOffsets[row],
+                                  x,this->mOffsets[row+1]-this->mOffsets[row]);
+        },threadsNumber,256);
+    }
+    std::vector<T> multiply(const std::vector<T>& x, std::size_t threadsNumber = 0) const
+    {
+        if(x.size()!=this->rows())
+        {
+            throw std::runtime_error("[SparseMatrix] Incorrect vector size: "+std::to_string(x.size()));
+        }
+        std::vector<T> y(this->rows());
+        this->multiply(x.data(),y.data(),threadsNumber);
+        return y;
+    }
+
+    // zwraca sumy kolumn (dla macierzy transponowanej - sumy wag krawędzi wychodzących)
+    std::vector<double> columnSums() const
+    {
+        std::vector<double> result(this->rows(),0.);
+        for(std::size_t i=0;i<this->mColumns.size();++i)
+        {
+            result[this->mColumns[i]] += this->mValues[i];
+        }
+        return result;
+    }
+private:
+    std::vector<std::size_t> mOffsets;
+    std::vector<std::uint32_t> mColumns;
+    std::vector<T> mValues;
+};
+
+template<typename T>
+template<typename V, typename E>
+SparseMatrix<T>::SparseMatrix(const Graph<V, E>& graph,
+                              std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeWeight,
+                              bool transposed)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(verticesNumber>=std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::runtime_error("[SparseMatrix] Too many vertices: "+std::to_string(verticesNumber));
+    }
+
+    this->mOffsets.assign(verticesNumber+1,0);
+    for(std::size_t v=0;v<verticesNumber;++v)
+    {
+        this->mOffsets[v+1] = transposed ? graph.inDegree(v) : graph.outDegree(v);
+    }
+    for(std::size_t v=0;v<verticesNumber;++v) this->mOffsets[v+1] += this->mOffsets[v];
+
+    this->mColumns.resize(this->mOffsets[verticesNumber]);
+    this->mValues.resize(this->mOffsets[verticesNumber]);
+    std::vector<std::size_t> fill(this->mOffsets.begin(),this->mOffsets.end()-1);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            std::size_t i = fill[transposed ? x : y]++;
+            this->mColumns[i] = static_cast<std::uint32_t>(transposed ? y : x);
+            this->mValues[i] = static_cast<T>(getEdgeWeight ? getEdgeWeight(graph.edgeLabel(y,x)) : 1.);
+        }
+    }
+}
+
+// wynik metod iteracyjnych
+template<typename T>
+class RankResult
+{
+public:
+    std::vector<T> ranks;
+    std::size_t iterations;
+    // norma L1 różnicy ostatnich dwóch przybliżeń
+    double residual;
+
+    bool converged(double tolerance) const
+    {
+        return this->residual<tolerance;
+    }
+};
+
+// PageRank z wektorem teleportacji "teleport" (suma 1) - iteracja potęgowa na transponowanej macierzy przejść
+// masa wierzchołków bez krawędzi wychodzących jest rozdzielana według wektora teleportacji
+// kończy się gdy norma L1 zmiany spadnie poniżej "tolerance", lub po "maxIterations" iteracjach
+template<typename T>
+RankResult<T> powerIterationRank(const SparseMatrix<T>& transposedMatrix, const std::vector<double>& outWeight,
+                                 const std::vector<T>& teleport, double damping, double tolerance,
+                                 std::size_t maxIterations, std::size_t threadsNumber)
+{
+    const std::size_t verticesNumber = transposedMatrix.rows();
+    RankResult<T> result{teleport,0,std::numeric_limits<double>::max()};
+    if(verticesNumber==0)
+    {
+        result.residual = 0;
+        return result;
+    }
+
+    std::vector<T> scaled(verticesNumber), next(verticesNumber);
+    while(result.iterations<maxIterations && result.residual>=tolerance)
+    {
+        double danglingMass = 0;
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            if(outWeight[v]>0) scaled[v] = static_cast<T>(result.ranks[v]/outWeight[v]);
+            else
+            {
+                scaled[v] = 0;
+                danglingMass += result.ranks[v];
+            }
+        }
+
+        transposedMatrix.multiply(scaled.data(),next.data(),threadsNumber);
+
+        const double teleportMass = (1.-damping)+damping*danglingMass;
+        double residual = 0;
+        double sum = 0;
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            double value = damping*static_cast<double>(next[v])+teleportMass*static_cast<double>(teleport[v]);
+            next[v] = static_cast<T>(value);
+            residual += std::abs(value-static_cast<double>(result.ranks[v]));
+            sum += value;
+        }
+        // korekta błędów zaokrągleń (ważne dla float)
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            next[v] = static_cast<T>(static_cast<double>(next[v])/sum);
+        }
+
+        result.ranks.swap(next);
+        result.residual = residual;
+        ++result.iterations;
+    }
+    return result;
+}
+
+// PageRank wszystkich wierzchołków (suma rang równa 1)
+// "getEdgeWeight" == nullptr - krawędzie wychodzące z wierzchołka są równo prawdopodobne
+// T - double lub float (float - połowa pamięci i przepustowości, dokładność ok. 1e-7)
+template<typename T = double, typename V, typename E>
+RankResult<T> pageRank(const Graph<V, E>& graph, double damping = 0.85, double tolerance = 1e-10,
+                       std::size_t maxIterations = 100,
+                       std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeWeight = nullptr,
+                       std::size_t threadsNumber = 0)
+{
+    if(damping<0.||damping>=1.)
+    {
+        throw std::runtime_error("[PageRank] Incorrect damping factor: "+std::to_string(damping));
+    }
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    SparseMatrix<T> matrix(graph,getEdgeWeight,true);
+    std::vector<T> teleport(verticesNumber,verticesNumber>0 ? static_cast<T>(1./static_cast<double>(verticesNumber)) : T(0));
+    return powerIterationRank(matrix,matrix.columnSums(),teleport,damping,tolerance,maxIterations,threadsNumber);
+}
+
+// spersonalizowany PageRank - teleportacja tylko do wierzchołków z "seeds" (równo prawdopodobnych)
+template<typename T = double, typename V, typename E>
+RankResult<T> personalizedPageRank(const Graph<V, E>& graph, const std::vector<std::size_t>& seeds,
+                                   double damping = 0.85, double tolerance = 1e-10,
+                                   std::size_t maxIterations = 100,
+                                   std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeWeight = nullptr,
+                                   std::size_t threadsNumber = 0)
+{
+    if(damping<0.||damping>=1.)
+    {
+        throw std::runtime_error("[PageRank] Incorrect damping factor: "+std::to_string(damping));
+    }
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(seeds.empty())
+    {
+        throw std::runtime_error("[PageRank] Empty seeds set");
+    }
+    std::vector<T> teleport(verticesNumber,T(0));
+    for(std::size_t seed: seeds)
+    {
+        if(seed>=verticesNumber)
+        {
+            throw std::runtime_error("[PageRank] Incorrect vertex index: "+std::to_string(seed));
+        }
+        teleport[seed] += static_cast<T>(1./static_cast<double>(seeds.size()));
+    }
+
+    SparseMatrix<T> matrix(graph,getEdgeWeight,true);
+    return powerIterationRank(matrix,matrix.columnSums(),teleport,damping,tolerance,maxIterations,threadsNumber);
+}
+
+// przybliżony spersonalizowany PageRank dla jednego wierzchołka (metoda "push", Andersen-Chung-Lang)
+// odwiedza tylko otoczenie "seed" - rangi są zaniżone, a łączny błąd (norma L1) jest mniejszy niż
+// epsilon * (liczba krawędzi + liczba wierzchołków)
+// zwraca niezerowe (id, ranga) malejąco po randze; krawędzie są równo prawdopodobne
+// masa wierzchołków bez krawędzi wychodzących wraca do "seed"
+template<typename T = double, typename V, typename E>
+std::vector<std::pair<std::size_t, T>> approximatePersonalizedPageRank(const Graph<V, E>& graph, std::size_t seed,
+                                                                       double damping = 0.85, double epsilon = 1e-7)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(seed>=verticesNumber)
+    {
+        throw std::runtime_error("[PageRank] Incorrect vertex index: "+std::to_string(seed));
+    }
+    if(damping<0.||damping>=1.)
+    {
+        throw std::runtime_error("[PageRank] Incorrect damping factor: "+std::to_string(damping));
+    }
+    if(!(epsilon>0.))
+    {
+        throw std::runtime_error("[PageRank] Incorrect epsilon: "+std::to_string(epsilon));
+    }
+
+    // listy sąsiedztwa wierzchołków, z których wypchnięto resztę (tylko te wiersze są skanowane, raz)
+    // progi pozostałych wierzchołków liczy "outDegree()" - O(1)
+    std::unordered_map<std::size_t, std::vector<std::size_t>> successors;
+    auto successorsOf = [&](std::size_t v)->const std::vector<std::size_t>&
+    {
+        auto it = successors.find(v);
+        if(it!=successors.end())return it->second;
+        std::vector<std::size_t>& list = successors[v];
+        list.reserve(graph.outDegree(v));
+        for(std::size_t x=graph.nextNeighbor(v,0);x<verticesNumber;x=graph.nextNeighbor(v,x+1))
+        {
+            list.push_back(x);
+        }
+        return list;
+    };
+
+    std::unordered_map<std::size_t, double> rank, residual;
+    std::vector<std::size_t> active;
+    residual[seed] = 1.;
+    active.push_back(seed);
+
+    while(!active.empty())
+    {
+        const std::size_t u = active.back();
+        active.pop_back();
+
+        const double degree = static_cast<double>(std::max<std::size_t>(graph.outDegree(u),1));
+        double r = residual[u];
+        if(r<epsilon*degree)continue;
+        const std::vector<std::size_t>& out = successorsOf(u);
+
+        rank[u] += (1.-damping)*r;
+        residual[u] = 0;
+        const double share = damping*r/degree;
+
+        auto push = [&](std::size_t x, double amount)
+        {
+            double& rx = residual[x];
+            const double threshold = epsilon*static_cast<double>(std::max<std::size_t>(graph.outDegree(x),1));
+            // wierzchołek trafia do aktywnych tylko raz, gdy przekroczy próg
+            if(rx<threshold && rx+amount>=threshold)active.push_back(x);
+            rx += amount;
+        };
+        if(out.empty())push(seed,damping*r);
+        for(std::size_t x: out) push(x,share);
+    }
+
+    std::vector<std::pair<std::size_t, T>> result;
+    result.reserve(rank.size());
+    for(const auto& [v, value]: rank)
+    {
+        result.emplace_back(v,static_cast<T>(value));
+    }
+    std::sort(result.begin(),result.end(),[](const std::pair<std::size_t, T>& a, const std::pair<std::size_t, T>& b)
+    {
+        return a.second!=b.second ? a.second>b.second : a.first<b.first;
+    });
+    return result;
+}
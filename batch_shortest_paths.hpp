@@ -0,0 +1,266 @@
+#pragma once
+#include "Graph.hpp"
+#include "BitMatrix.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+
+// odpowiada na paczkę zapytań (start, koniec) - wyniki w kolejności zapytań, w tej samej postaci co "dijkstra()":
+// (długość, id wierzchołków ścieżki), lub (std::numeric_limits<double>::max(), {}) gdy ścieżki nie ma
+// zapytania są grupowane po wierzchołku startowym i każda grupa jest obsługiwana jednym szukaniem,
+// które kończy się po osiągnięciu wszystkich celów grupy; grupy są przetwarzane równolegle
+// "getEdgeLength" == nullptr - graf nieważony (długość = liczba krawędzi): BFS z 64 źródeł naraz,
+// gdzie bit "i" słowa wierzchołka oznacza, że dotarło do niego szukanie z i-tego źródła (MS-BFS)
+template<typename V, typename E>
+std::vector<std::pair<double, std::vector<std::size_t>>>
+batchShortestPaths(const Graph<V, E>& graph, const std::vector<std::pair<std::size_t, std::size_t>>& queries,
+                   std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeLength =
+                   [](const E&edge)->double{return edge;},
+                   std::size_t threadsNumber = 0)
+{
+    constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+    constexpr std::size_t LANES = BitMatrix::WORD_BITS;
+    // id wierzchołków w poziomach MS-BFS są 32-bitowe
+    constexpr std::size_t MAX_VERTICES = std::numeric_limits<std::uint32_t>::max();
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    for(const auto& [start_idx, end_idx]: queries)
+    {
+        if(start_idx>=verticesNumber|| end_idx>=verticesNumber)
+        {
+            std::size_t var1 = std::max(start_idx,end_idx);
+            throw std::runtime_error("[Batch shortest paths] Incorrect vertex index: "
+                                     +std::to_string(var1));
+        }
+    }
+
+    if(!getEdgeLength&&verticesNumber>=MAX_VERTICES)
+    {
+        throw std::runtime_error("[Batch shortest paths] Too many vertices: "
+                                 +std::to_string(verticesNumber));
+    }
+
+    std::vector<std::pair<double, std::vector<std::size_t>>> result(queries.size(),
+            std::make_pair(MAX_DOUBLE_VALUE,std::vector<std::size_t>()));
+    if(queries.empty())return result;
+
+    // listy sąsiedztwa (CSR)
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    std::vector<std::size_t> targets;
+    std::vector<double> lengths;
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            targets.push_back(x);
+            if(getEdgeLength)lengths.push_back(getEdgeLength(graph.edgeLabel(y,x)));
+        }
+        offsets[y+1] = targets.size();
+    }
+
+    // grupy: zapytania posortowane po starcie, groupBegin[g] - pierwsze zapytanie grupy "g"
+    std::vector<std::size_t> order(queries.size());
+    for(std::size_t i=0;i<order.size();++i) order[i] = i;
+    std::stable_sort(order.begin(),order.end(),[&](std::size_t a, std::size_t b)
+    {
+        return queries[a].first<queries[b].first;
+    });
+    std::vector<std::size_t> groupBegin;
+    for(std::size_t i=0;i<order.size();++i)
+    {
+        if(i==0||queries[order[i]].first!=queries[order[i-1]].first)groupBegin.push_back(i);
+    }
+    const std::size_t groupsNumber = groupBegin.size();
+    groupBegin.push_back(order.size());
+
+    auto makePath = [&](std::size_t start_idx, std::size_t end_idx, auto precursorOf)
+    {
+        std::vector<std::size_t> path;
+        for(std::size_t v=end_idx; v!=start_idx; v=precursorOf(v)) path.push_back(v);
+        path.push_back(start_idx);
+        std::reverse(path.begin(),path.end());
+        return path;
+    };
+
+    if(getEdgeLength)
+    {
+        // Dijkstra z kopcem dla każdej grupy
+        parallelFor(0,groupsNumber,[&](std::size_t g)
+        {
+            const std::size_t start_idx = queries[order[groupBegin[g]]].first;
+            std::vector<double> distance(verticesNumber,MAX_DOUBLE_VALUE);
+            std::vector<std::size_t> precursor(verticesNumber,verticesNumber);
+            std::vector<bool> isTarget(verticesNumber,false);
+            std::size_t remainingTargets = 0;
+            for(std::size_t i=groupBegin[g];i<groupBegin[g+1];++i)
+            {
+                const std::size_t end_idx = queries[order[i]].second;
+                if(!isTarget[end_idx])
+                {
+                    isTarget[end_idx] = true;
+                    ++remainingTargets;
+                }
+            }
+
+            using QueueEntry = std::pair<double, std::size_t>;
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> q1;
+            distance[start_idx] = 0;
+            q1.emplace(0.,start_idx);
+            while(!q1.empty()&&remainingTargets>0)
+            {
+                auto [d, vId] = q1.top();
+                q1.pop();
+                if(d>distance[vId])continue;
+                if(isTarget[vId])
+                {
+                    isTarget[vId] = false;
+                    --remainingTargets;
+                }
+
+                for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+                {
+                    double newDistance = d+lengths[i];
+                    if(newDistance<distance[targets[i]])
+                    {
+                        distance[targets[i]] = newDistance;
+                        precursor[targets[i]] = vId;
+                        q1.emplace(newDistance,targets[i]);
+                    }
+                }
+            }
+
+            for(std::size_t i=groupBegin[g];i<groupBegin[g+1];++i)
+            {
+                const std::size_t end_idx = queries[order[i]].second;
+                if(distance[end_idx]==MAX_DOUBLE_VALUE)continue;
+                result[order[i]] = std::make_pair(distance[end_idx],makePath(start_idx,end_idx,[&](std::size_t v)
+                {
+                    return precursor[v];
+                }));
+            }
+        },threadsNumber);
+        return result;
+    }
+
+    // poprzednicy wierzchołków (CSR), rosnąco po id - do odtwarzania ścieżek
+    std::vector<std::size_t> reverseOffsets(verticesNumber+1,0);
+    for(std::size_t x: targets) ++reverseOffsets[x+1];
+    for(std::size_t v=0;v<verticesNumber;++v) reverseOffsets[v+1] += reverseOffsets[v];
+    std::vector<std::size_t> sources(targets.size());
+    {
+        std::vector<std::size_t> fill(reverseOffsets.begin(),reverseOffsets.end()-1);
+        for(std::size_t y=0;y<verticesNumber;++y)
+        {
+            for(std::size_t i=offsets[y];i<offsets[y+1];++i) sources[fill[targets[i]]++] = y;
+        }
+    }
+
+    // MS-BFS: grupy są łączone w porcje po 64 źródła
+    const std::size_t batchesNumber = (groupsNumber+LANES-1)/LANES;
+    parallelFor(0,batchesNumber,[&](std::size_t b)
+    {
+        const std::size_t firstGroup = b*LANES;
+        const std::size_t lanesNumber = std::min(LANES,groupsNumber-firstGroup);
+
+        std::vector<std::uint64_t> seen(verticesNumber,0), visit(verticesNumber,0), visitNext(verticesNumber,0);
+        // kolejne poziomy BFS: wierzchołki (rosnąco po id) razem ze źródłami, które właśnie do nich dotarły
+        // zamiast poprzednika dla każdej pary (źródło, wierzchołek) - rozmiar zależy od liczby odkryć, a nie od 64 * V
+        std::vector<std::uint32_t> levelVertices;
+        std::vector<std::uint64_t> levelLanes;
+        std::vector<std::size_t> levelBegin(1,0);
+
+        for(std::size_t lane=0;lane<lanesNumber;++lane)
+        {
+            const std::size_t start_idx = queries[order[groupBegin[firstGroup+lane]]].first;
+            seen[start_idx] |= std::uint64_t(1)<<lane;
+            visit[start_idx] |= std::uint64_t(1)<<lane;
+        }
+
+        // liczba celów (z powtórzeniami) jeszcze nieosiągniętych przez swoje źródło
+        auto pendingQueries = [&]()
+        {
+            std::size_t pending = 0;
+            for(std::size_t lane=0;lane<lanesNumber;++lane)
+            {
+                const std::size_t g = firstGroup+lane;
+                for(std::size_t i=groupBegin[g];i<groupBegin[g+1];++i)
+                {
+                    if(!((seen[queries[order[i]].second]>>lane)&1u))++pending;
+                }
+            }
+            return pending;
+        };
+
+        bool frontier = true;
+        while(frontier && pendingQueries()>0)
+        {
+            frontier = false;
+            for(std::size_t vId=0;vId<verticesNumber;++vId)
+            {
+                const std::uint64_t lanes = visit[vId];
+                if(lanes==0)continue;
+                levelVertices.push_back(static_cast<std::uint32_t>(vId));
+                levelLanes.push_back(lanes);
+                for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+                {
+                    const std::size_t x = targets[i];
+                    std::uint64_t discovered = lanes&~seen[x];
+                    if(discovered==0)continue;
+
+                    seen[x] |= discovered;
+                    visitNext[x] |= discovered;
+                    frontier = true;
+                }
+            }
+            levelBegin.push_back(levelVertices.size());
+            visit.swap(visitNext);
+            std::fill(visitNext.begin(),visitNext.end(),0);
+        }
+        // ostatni poziom (osiągnięte cele)
+        for(std::size_t vId=0;vId<verticesNumber;++vId)
+        {
+            if(visit[vId]==0)continue;
+            levelVertices.push_back(static_cast<std::uint32_t>(vId));
+            levelLanes.push_back(visit[vId]);
+        }
+        levelBegin.push_back(levelVertices.size());
+
+        // czy źródło "lane" dotarło do "v" dokładnie na poziomie "level"
+        auto reachedAt = [&](std::size_t v, std::size_t level, std::size_t lane)
+        {
+            auto first = levelVertices.begin()+levelBegin[level], last = levelVertices.begin()+levelBegin[level+1];
+            auto it = std::lower_bound(first,last,static_cast<std::uint32_t>(v));
+            return it!=last && *it==v && ((levelLanes[it-levelVertices.begin()]>>lane)&1u);
+        };
+
+        for(std::size_t lane=0;lane<lanesNumber;++lane)
+        {
+            const std::size_t g = firstGroup+lane;
+            for(std::size_t i=groupBegin[g];i<groupBegin[g+1];++i)
+            {
+                const std::size_t end_idx = queries[order[i]].second;
+                if(!((seen[end_idx]>>lane)&1u))continue;
+
+                std::size_t level = 0;
+                while(!reachedAt(end_idx,level,lane)) ++level;
+
+                // cofanie się po poziomach: poprzednik o najmniejszym id, do którego źródło dotarło poziom wcześniej
+                std::vector<std::size_t> path(level+1);
+                path[level] = end_idx;
+                for(std::size_t v=end_idx;level>0;--level)
+                {
+                    std::size_t r = reverseOffsets[v];
+                    while(!reachedAt(sources[r],level-1,lane)) ++r;
+                    v = sources[r];
+                    path[level-1] = v;
+                }
+                result[order[i]] = std::make_pair(static_cast<double>(path.size()-1),std::move(path));
+            }
+        }
+    },threadsNumber);
+
+    return result;
+}
@@ -0,0 +1,283 @@
+#pragma once
+#include "Graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// centralność pośrednictwa (betweenness) algorytmem Brandesa: z każdego źródła jedno szukanie (BFS, lub Dijkstra
+// z kopcem dla grafu ważonego), a następnie zbieranie zależności w odwrotnej kolejności odwiedzenia - O(VE + V^2 log V)
+// wartość wierzchołka v: suma po parach (s, t), s != v != t, udziału najkrótszych ścieżek s->t przechodzących przez v
+// (pary uporządkowane; w grafie nieskierowanym każda para {s, t} liczy się raz)
+// "getEdgeLength" == nullptr - graf nieważony, w przeciwnym razie długości krawędzi muszą być dodatnie
+// pętle są pomijane; źródła są dzielone między wątki, każdy wątek zbiera zależności we własnych tablicach
+
+// wynik "betweenness()" / "approximateBetweenness()"
+class BetweennessResult
+{
+public:
+    // centralność wierzchołków (według id)
+    std::vector<double> vertices;
+    // krawędzie (y, x) rosnąco - w grafie nieskierowanym każda raz, z y > x - i ich centralność
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    std::vector<double> edgeValues;
+    // liczba szukań (źródeł)
+    std::size_t samples;
+    // wynik przybliżony: z prawdopodobieństwem co najmniej 1 - delta każda wartość "vertices" różni się od
+    // dokładnej o co najwyżej "errorBound" (0 dla wyniku dokładnego)
+    double errorBound;
+};
+
+// zbiera zależności ze szukań z "sources" - wartości są sumami po źródłach (bez skalowania)
+template<typename V, typename E>
+void brandesAccumulate(const Graph<V, E>& graph, const std::vector<std::size_t>& sources,
+                       const std::function<double(const typename Graph<V, E>::edge_type&)>& getEdgeLength,
+                       std::size_t threadsNumber, BetweennessResult& result)
+{
+    constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    // listy sąsiedztwa (CSR) bez pętli, sąsiedzi rosnąco po id
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    std::vector<std::size_t> targets;
+    std::vector<double> lengths;
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x==y)continue;
+            targets.push_back(x);
+            if(getEdgeLength)
+            {
+                const double length = getEdgeLength(graph.edgeLabel(y,x));
+                if(!(length>0.)||length==MAX_DOUBLE_VALUE)
+                {
+                    throw std::runtime_error("[Betweenness] Incorrect edge length: "+std::to_string(length));
+                }
+                lengths.push_back(length);
+            }
+        }
+        offsets[y+1] = targets.size();
+    }
+
+    const std::size_t workersNumber = std::max<std::size_t>(
+                std::min(threadsNumberOrDefault(threadsNumber),sources.size()),1);
+    std::vector<std::vector<double>> vertexSums(workersNumber), arcSums(workersNumber);
+
+    // wątek "t" obsługuje źródła t, t + workersNumber, ... - wynik nie zależy od przydziału wątków
+    parallelFor(0,workersNumber,[&](std::size_t t)
+    {
+        std::vector<double>& vertexSum = vertexSums[t];
+        std::vector<double>& arcSum = arcSums[t];
+        vertexSum.assign(verticesNumber,0.);
+        arcSum.assign(targets.size(),0.);
+
+        std::vector<double> distance(verticesNumber,MAX_DOUBLE_VALUE), sigma(verticesNumber,0.), delta(verticesNumber,0.);
+        std::vector<std::size_t> order;
+        order.reserve(verticesNumber);
+        using QueueEntry = std::pair<double, std::size_t>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> heap;
+
+        for(std::size_t si=t;si<sources.size();si+=workersNumber)
+        {
+            const std::size_t s = sources[si];
+            distance[s] = 0.;
+            sigma[s] = 1.;
+
+            // 1. szukanie z "s" - liczba najkrótszych ścieżek "sigma", wierzchołki w kolejności odległości
+            if(!getEdgeLength)
+            {
+                order.push_back(s);
+                for(std::size_t head=0;head<order.size();++head)
+                {
+                    const std::size_t v = order[head];
+                    for(std::size_t i=offsets[v];i<offsets[v+1];++i)
+                    {
+                        const std::size_t w = targets[i];
+                        if(distance[w]==MAX_DOUBLE_VALUE)
+                        {
+                            distance[w] = distance[v]+1.;
+                            order.push_back(w);
+                        }
+                        if(distance[w]==distance[v]+1.)sigma[w] += sigma[v];
+                    }
+                }
+            }
+            else
+            {
+                heap.emplace(0.,s);
+                while(!heap.empty())
+                {
+                    const auto [d, v] = heap.top();
+                    heap.pop();
+                    if(d!=distance[v]||delta[v]<0.)continue;
+                    // znacznik odwiedzenia (zerowany przy zbieraniu zależności)
+                    delta[v] = -1.;
+                    order.push_back(v);
+                    for(std::size_t i=offsets[v];i<offsets[v+1];++i)
+                    {
+                        const std::size_t w = targets[i];
+                        const double newDistance = d+lengths[i];
+                        if(newDistance<distance[w])
+                        {
+                            distance[w] = newDistance;
+                            sigma[w] = sigma[v];
+                            heap.emplace(newDistance,w);
+                        }
+                        else if(newDistance==distance[w])
+                        {
+                            sigma[w] += sigma[v];
+                        }
+                    }
+                }
+            }
+
+            // 2. zależności w odwrotnej kolejności - następniki "v" w drzewie najkrótszych ścieżek są już policzone
+            for(std::size_t k=order.size();k-->0;)
+            {
+                const std::size_t v = order[k];
+                double dependency = 0.;
+                for(std::size_t i=offsets[v];i<offsets[v+1];++i)
+                {
+                    const std::size_t w = targets[i];
+                    const double step = getEdgeLength ? lengths[i] : 1.;
+                    if(distance[w]==MAX_DOUBLE_VALUE||distance[w]!=distance[v]+step)continue;
+                    const double c = sigma[v]/sigma[w]*(1.+delta[w]);
+                    arcSum[i] += c;
+                    dependency += c;
+                }
+                delta[v] = dependency;
+                if(v!=s)vertexSum[v] += dependency;
+            }
+
+            for(std::size_t v: order)
+            {
+                distance[v] = MAX_DOUBLE_VALUE;
+                sigma[v] = 0.;
+                delta[v] = 0.;
+            }
+            order.clear();
+        }
+    },workersNumber,1);
+
+    result.vertices.assign(verticesNumber,0.);
+    std::vector<double> arcs(targets.size(),0.);
+    for(std::size_t t=0;t<workersNumber;++t)
+    {
+        for(std::size_t v=0;v<verticesNumber;++v) result.vertices[v] += vertexSums[t][v];
+        for(std::size_t i=0;i<targets.size();++i) arcs[i] += arcSums[t][i];
+    }
+
+    // w grafie nieskierowanym krawędź y-x to łuki y->x i x->y
+    result.edges.clear();
+    result.edgeValues.clear();
+    const bool undirected = graph.kind()==GraphKind::Undirected;
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t i=offsets[y];i<offsets[y+1];++i)
+        {
+            const std::size_t x = targets[i];
+            if(!undirected)
+            {
+                result.edges.emplace_back(y,x);
+                result.edgeValues.push_back(arcs[i]);
+            }
+            else if(y>x)
+            {
+                auto reverse = std::lower_bound(targets.begin()+offsets[x],targets.begin()+offsets[x+1],y);
+                result.edges.emplace_back(y,x);
+                result.edgeValues.push_back(arcs[i]+arcs[reverse-targets.begin()]);
+            }
+        }
+    }
+    result.samples = sources.size();
+    result.errorBound = 0.;
+}
+
+// dokładna centralność pośrednictwa - szukanie z każdego wierzchołka
+template<typename V, typename E>
+BetweennessResult betweenness(const Graph<V, E>& graph,
+                              std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeLength = nullptr,
+                              std::size_t threadsNumber = 0)
+{
+    std::vector<std::size_t> sources(graph.nrOfVertices());
+    for(std::size_t v=0;v<sources.size();++v) sources[v] = v;
+
+    BetweennessResult result;
+    brandesAccumulate(graph,sources,getEdgeLength,threadsNumber,result);
+    if(graph.kind()==GraphKind::Undirected)
+    {
+        for(double& value: result.vertices) value /= 2.;
+        for(double& value: result.edgeValues) value /= 2.;
+    }
+    return result;
+}
+
+// liczba losowych źródeł, dla której "approximateBetweenness()" z prawdopodobieństwem co najmniej 1 - delta daje
+// wartości wierzchołków z błędem co najwyżej epsilon * V * (V - 2) (nierówność Hoeffdinga i ograniczenie łączne
+// po wierzchołkach - błąd centralności znormalizowanej do [0, 1] jest rzędu epsilon)
+inline std::size_t betweennessSamples(std::size_t verticesNumber, double epsilon, double delta = 0.1)
+{
+    if(!(epsilon>0.)||!(delta>0.&&delta<1.))
+    {
+        throw std::runtime_error("[Betweenness] Incorrect error bound parameters");
+    }
+    const double n = static_cast<double>(std::max<std::size_t>(verticesNumber,1));
+    return static_cast<std::size_t>(std::ceil(std::log(2.*n/delta)/(2.*epsilon*epsilon)));
+}
+
+// przybliżona centralność pośrednictwa (Brandes, Pich) - szukania z "samples" źródeł losowanych ze zwracaniem,
+// sumy zależności są skalowane przez V / samples (estymator nieobciążony, także dla krawędzi)
+// "errorBound" wyniku: epsilon * V * (V - 2), epsilon = sqrt(ln(2V / delta) / (2 * samples))
+// (połowa tego w grafie nieskierowanym) - zależność jednego źródła od wierzchołka jest w [0, V - 2]
+// "seed" - ziarno generatora, ten sam "seed" daje te same źródła
+template<typename V, typename E>
+BetweennessResult approximateBetweenness(const Graph<V, E>& graph, std::size_t samples,
+                                         std::function<double(const typename Graph<V, E>::edge_type&)>
+                                         getEdgeLength = nullptr,
+                                         double delta = 0.1, std::uint64_t seed = 0, std::size_t threadsNumber = 0)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(samples==0)
+    {
+        throw std::runtime_error("[Betweenness] Number of samples must be positive");
+    }
+    if(!(delta>0.&&delta<1.))
+    {
+        throw std::runtime_error("[Betweenness] Incorrect confidence parameter: "+std::to_string(delta));
+    }
+
+    std::vector<std::size_t> sources;
+    if(verticesNumber>0)
+    {
+        std::mt19937_64 generator(seed);
+        std::uniform_int_distribution<std::size_t> vertex(0,verticesNumber-1);
+        sources.resize(samples);
+        for(std::size_t& s: sources) s = vertex(generator);
+    }
+
+    BetweennessResult result;
+    brandesAccumulate(graph,sources,getEdgeLength,threadsNumber,result);
+
+    const double n = static_cast<double>(verticesNumber);
+    double scale = n/static_cast<double>(samples);
+    double errorBound = verticesNumber>2
+            ? std::sqrt(std::log(2.*n/delta)/(2.*static_cast<double>(samples)))*n*(n-2.) : 0.;
+    if(graph.kind()==GraphKind::Undirected)
+    {
+        scale /= 2.;
+        errorBound /= 2.;
+    }
+    for(double& value: result.vertices) value *= scale;
+    for(double& value: result.edgeValues) value *= scale;
+    result.samples = samples;
+    result.errorBound = errorBound;
+    return result;
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include "Graph.hpp"
+#include <functional>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <queue>
+
+// zwraca wierzchołki w porządku topologicznym (algorytm Kahna, przy remisie najmniejsze id),
+// lub std::nullopt jeżeli graf zawiera cykl
+template<typename V, typename E>
+std::optional<std::vector<std::size_t>> topologicalSort(const Graph<V, E>& graph)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    std::vector<std::size_t> inDegree(verticesNumber, 0);
+    for(std::size_t v=0;v<verticesNumber;++v) inDegree[v] = graph.inDegree(v);
+
+    // kopiec minimalny - spośród gotowych wierzchołków zawsze wybierany jest ten o najmniejszym id
+    std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>> ready;
+    for(std::size_t i=0;i<verticesNumber;++i)
+    {
+        if(inDegree[i]==0) ready.push(i);
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(verticesNumber);
+
+    while(!ready.empty())
+    {
+        std::size_t vId = ready.top();
+        ready.pop();
+        order.push_back(vId);
+
+        for(std::size_t i=graph.nextNeighbor(vId,0);i<verticesNumber;i=graph.nextNeighbor(vId,i+1))
+        {
+            if(--inDegree[i]==0)
+            {
+                ready.push(i);
+            }
+        }
+    }
+
+    if(order.size()!=verticesNumber) return std::nullopt;
+    return order;
+}
+
+// zwraca true jeżeli graf nie zawiera cykli
+template<typename V, typename E>
+bool isAcyclic(const Graph<V, E>& graph)
+{
+    return topologicalSort(graph).has_value();
+}
+
+template<bool Longest, typename V, typename E>
+std::pair<double, std::vector<std::size_t>> dagPaths(const Graph<V, E>& graph,
+        const std::vector<std::size_t>& order,
+        std::size_t start_idx, std::size_t end_idx,
+        const std::function<double(const E&)>& getEdgeLength)
+{
+    constexpr double UNREACHED = Longest ? std::numeric_limits<double>::lowest()
+                                         : std::numeric_limits<double>::max();
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    std::vector<double> distance(verticesNumber, UNREACHED);
+    std::vector<std::size_t> precursor(verticesNumber, verticesNumber);
+    distance[start_idx] = 0;
+
+    auto it = std::find(order.begin(),order.end(),start_idx);
+    for(;it!=order.end();++it)
+    {
+        const std::size_t vId = *it;
+        if(vId==end_idx)break;
+        if(distance[vId]==UNREACHED)continue;
+
+        for(std::size_t i=graph.nextNeighbor(vId,0);i<verticesNumber;i=graph.nextNeighbor(vId,i+1))
+        {
+            double newDistance = distance[vId] + getEdgeLength(graph.edgeLabel(vId,i));
+            if(Longest ? newDistance > distance[i] : newDistance < distance[i])
+            {
+                distance[i] = newDistance;
+                precursor[i] = vId;
+            }
+        }
+    }
+
+    if(distance[end_idx]==UNREACHED)
+    {
+        return std::make_pair(std::numeric_limits<double>::max(),std::vector<std::size_t>());
+    }
+
+    std::vector<std::size_t> result;
+    for(std::size_t vId = end_idx; vId!=start_idx; vId = precursor[vId])
+    {
+        result.push_back(vId);
+    }
+    result.push_back(start_idx);
+
+    std::reverse(result.begin(),result.end());
+    return std::make_pair(distance[end_idx],result);
+}
+
+template<bool Longest, typename V, typename E>
+std::pair<double, std::vector<std::size_t>> dagPaths(const Graph<V, E>& graph,
+        std::size_t start_idx, std::size_t end_idx,
+        const std::function<double(const E&)>& getEdgeLength, const char* name)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(start_idx>=verticesNumber|| end_idx>=verticesNumber)
+    {
+        std::size_t var1 = std::max(start_idx,end_idx);
+        throw std::runtime_error(std::string(name)+" Incorrect vertex index: "
+                                 +std::to_string(var1));
+    }
+
+    std::optional<std::vector<std::size_t>> order = topologicalSort(graph);
+    if(!order.has_value())
+    {
+        throw std::runtime_error(std::string(name)+" Graph contains a cycle");
+    }
+
+    return dagPaths<Longest>(graph,order.value(),start_idx,end_idx,getEdgeLength);
+}
+
+// najkrótsza ścieżka w grafie acyklicznym - każda krawędź relaksowana raz, w porządku topologicznym (bez kolejki priorytetowej)
+// zwraca to samo co "dijkstra()"; dla grafu z cyklem zgłasza wyjątek
+template<typename V, typename E>
+std::pair<double, std::vector<std::size_t>> dagShortestPaths(const Graph<V, E>& graph,
+        std::size_t start_idx, std::size_t end_idx,
+        std::function<double(const E&)> getEdgeLength =
+        [](const E&edge)->double{return edge;})
+{
+    return dagPaths<false>(graph,start_idx,end_idx,getEdgeLength,"[DAG shortest paths]");
+}
+
+// najdłuższa ścieżka w grafie acyklicznym między podanymi wierzchołkami
+template<typename V, typename E>
+std::pair<double, std::vector<std::size_t>> dagLongestPaths(const Graph<V, E>& graph,
+        std::size_t start_idx, std::size_t end_idx,
+        std::function<double(const E&)> getEdgeLength =
+        [](const E&edge)->double{return edge;})
+{
+    return dagPaths<true>(graph,start_idx,end_idx,getEdgeLength,"[DAG longest paths]");
+}
+
+// ścieżka krytyczna - najdłuższa ścieżka w całym grafie acyklicznym
+template<typename V, typename E>
+std::pair<double, std::vector<std::size_t>> criticalPath(const Graph<V, E>& graph,
+        std::function<double(const E&)> getEdgeLength =
+        [](const E&edge)->double{return edge;})
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(verticesNumber==0)
+    {
+        return std::make_pair(0.,std::vector<std::size_t>());
+    }
+
+    std::optional<std::vector<std::size_t>> order = topologicalSort(graph);
+    if(!order.has_value())
+    {
+        throw std::runtime_error("[Critical path] Graph contains a cycle");
+    }
+
+    std::vector<double> distance(verticesNumber, 0.);
+    std::vector<std::size_t> precursor(verticesNumber, verticesNumber);
+
+    for(std::size_t vId: order.value())
+    {
+        for(std::size_t i=graph.nextNeighbor(vId,0);i<verticesNumber;i=graph.nextNeighbor(vId,i+1))
+        {
+            double newDistance = distance[vId] + getEdgeLength(graph.edgeLabel(vId,i));
+            if(newDistance > distance[i])
+            {
+                distance[i] = newDistance;
+                precursor[i] = vId;
+            }
+        }
+    }
+
+    std::size_t end_idx = std::max_element(distance.begin(),distance.end()) - distance.begin();
+
+    std::vector<std::size_t> result;
+    for(std::size_t vId = end_idx; vId<verticesNumber; vId = precursor[vId])
+    {
+        result.push_back(vId);
+    }
+
+    std::reverse(result.begin(),result.end());
+    return std::make_pair(distance[end_idx],result);
+}
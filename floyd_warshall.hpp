@@ -0,0 +1,309 @@
+#pragma once
+#include "Graph.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#if defined(GRAPH_SIMD_AVX2)
+// początek wiersza kroku min-plus, po 4 / 8 kolumn naraz - zwraca liczbę przetworzonych kolumn
+inline GRAPH_SIMD_TARGET("avx2") std::size_t minPlusRowAvx2(double dik, const double* dk, const std::uint32_t* pk,
+                                                            double* di, std::uint32_t* pi, std::size_t n)
+{
+    std::size_t j = 0;
+    const __m256d a = _mm256_set1_pd(dik);
+    const __m256i pack = _mm256_setr_epi32(0,2,4,6,0,2,4,6);
+    for(;j+4<=n;j+=4)
+    {
+        __m256d newDistance = _mm256_add_pd(a,_mm256_loadu_pd(dk+j));
+        __m256d oldDistance = _mm256_loadu_pd(di+j);
+        __m256d better = _mm256_cmp_pd(newDistance,oldDistance,_CMP_LT_OQ);
+        _mm256_storeu_pd(di+j,_mm256_blendv_pd(oldDistance,newDistance,better));
+
+        __m128i mask = _mm256_castsi256_si128(
+                    _mm256_permutevar8x32_epi32(_mm256_castpd_si256(better),pack));
+        __m128i oldPrecursor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pi+j));
+        __m128i newPrecursor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pk+j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pi+j),
+                         _mm_or_si128(_mm_and_si128(mask,newPrecursor),_mm_andnot_si128(mask,oldPrecursor)));
+    }
+    return j;
+}
+
+inline GRAPH_SIMD_TARGET("avx2") std::size_t minPlusRowAvx2(float dik, const float* dk, const std::uint32_t* pk,
+                                                            float* di, std::uint32_t* pi, std::size_t n)
+{
+    std::size_t j = 0;
+    const __m256 a = _mm256_set1_ps(dik);
+    for(;j+8<=n;j+=8)
+    {
+        __m256 newDistance = _mm256_add_ps(a,_mm256_loadu_ps(dk+j));
+        __m256 oldDistance = _mm256_loadu_ps(di+j);
+        __m256 better = _mm256_cmp_ps(newDistance,oldDistance,_CMP_LT_OQ);
+        _mm256_storeu_ps(di+j,_mm256_blendv_ps(oldDistance,newDistance,better));
+
+        __m256i mask = _mm256_castps_si256(better);
+        __m256i oldPrecursor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pi+j));
+        __m256i newPrecursor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pk+j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pi+j),
+                            _mm256_blendv_epi8(oldPrecursor,newPrecursor,mask));
+    }
+    return j;
+}
+#endif
+
+// jeden wiersz kroku min-plus: di[j] = min(di[j], dik+dk[j]), przy poprawie pi[j] = pk[j]
+inline void minPlusRow(double dik, const double* dk, const std::uint32_t* pk,
+                       double* di, std::uint32_t* pi, std::size_t n)
+{
+    std::size_t j = 0;
+#if defined(GRAPH_SIMD_AVX2)
+    if(cpuSupportsAvx2()) j = minPlusRowAvx2(dik,dk,pk,di,pi,n);
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128d a = _mm_set1_pd(dik);
+    for(;j+2<=n;j+=2)
+    {
+        __m128d newDistance = _mm_add_pd(a,_mm_loadu_pd(dk+j));
+        __m128d oldDistance = _mm_loadu_pd(di+j);
+        __m128d better = _mm_cmplt_pd(newDistance,oldDistance);
+        _mm_storeu_pd(di+j,_mm_or_pd(_mm_and_pd(better,newDistance),_mm_andnot_pd(better,oldDistance)));
+
+        __m128i mask = _mm_shuffle_epi32(_mm_castpd_si128(better),_MM_SHUFFLE(2,0,2,0));
+        __m128i oldPrecursor = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pi+j));
+        __m128i newPrecursor = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pk+j));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pi+j),
+                         _mm_or_si128(_mm_and_si128(mask,newPrecursor),_mm_andnot_si128(mask,oldPrecursor)));
+    }
+#endif
+    for(;j<n;++j)
+    {
+        const double newDistance = dik+dk[j];
+        if(newDistance<di[j])
+        {
+            di[j] = newDistance;
+            pi[j] = pk[j];
+        }
+    }
+}
+
+inline void minPlusRow(float dik, const float* dk, const std::uint32_t* pk,
+                       float* di, std::uint32_t* pi, std::size_t n)
+{
+    std::size_t j = 0;
+#if defined(GRAPH_SIMD_AVX2)
+    if(cpuSupportsAvx2()) j = minPlusRowAvx2(dik,dk,pk,di,pi,n);
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128 a = _mm_set1_ps(dik);
+    for(;j+4<=n;j+=4)
+    {
+        __m128 newDistance = _mm_add_ps(a,_mm_loadu_ps(dk+j));
+        __m128 oldDistance = _mm_loadu_ps(di+j);
+        __m128 better = _mm_cmplt_ps(newDistance,oldDistance);
+        _mm_storeu_ps(di+j,_mm_or_ps(_mm_and_ps(better,newDistance),_mm_andnot_ps(better,oldDistance)));
+
+        __m128i mask = _mm_castps_si128(better);
+        __m128i oldPrecursor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pi+j));
+        __m128i newPrecursor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pk+j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pi+j),
+                         _mm_or_si128(_mm_and_si128(mask,newPrecursor),_mm_andnot_si128(mask,oldPrecursor)));
+    }
+#endif
+    for(;j<n;++j)
+    {
+        const float newDistance = dik+dk[j];
+        if(newDistance<di[j])
+        {
+            di[j] = newDistance;
+            pi[j] = pk[j];
+        }
+    }
+}
+
+// najkrótsze ścieżki między wszystkimi parami wierzchołków (blokowy algorytm Floyda-Warshalla)
+// T - typ odległości: double, lub float (o połowę mniej pamięci i przepustowości, mniejsza dokładność)
+// macierz jest dzielona na kafelki TILE x TILE, każda runda "k" to: kafelek przekątnej,
+// kafelki jego wiersza i kolumny (równolegle), pozostałe kafelki (równolegle)
+// migawka - po modyfikacji grafu należy policzyć odległości ponownie
+template<typename T = double>
+class AllPairsShortestPaths
+{
+public:
+    static_assert(std::is_same<T,float>::value || std::is_same<T,double>::value,
+                  "[Floyd-Warshall] Distance type must be float or double");
+
+    // 64x64 kafelki: trzy kafelki rundy (float: 48 KB, double: 96 KB) mieszczą się w L2
+    static constexpr std::size_t TILE = 64;
+    static constexpr std::uint32_t NO_PRECURSOR = std::numeric_limits<std::uint32_t>::max();
+
+    template<typename V, typename E>
+    explicit AllPairsShortestPaths(const Graph<V, E>& graph,
+                                   std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeLength =
+                                   [](const E&edge)->double{return edge;},
+                                   std::size_t threadsNumber = 0);
+
+    // zwraca długość najkrótszej ścieżki z "u" do "v", lub std::numeric_limits<T>::max() gdy ścieżka nie istnieje
+    T distance(std::size_t u, std::size_t v) const
+    {
+        this->mCheckVertex(u);
+        this->mCheckVertex(v);
+        T result = this->mDistance[u*this->mStride+v];
+        return result==INF ? std::numeric_limits<T>::max() : result;
+    }
+
+    // zwraca id wierzchołków najkrótszej ścieżki z "u" do "v", lub pusty wektor gdy ścieżka nie istnieje
+    std::vector<std::size_t> path(std::size_t u, std::size_t v) const;
+
+    // zwraca true jeśli graf zawiera cykl o ujemnej długości (odległości nie są wtedy poprawne)
+    bool hasNegativeCycle() const
+    {
+        for(std::size_t i=0;i<this->mVerticesNumber;++i)
+        {
+            if(this->mDistance[i*this->mStride+i]<0)return true;
+        }
+        return false;
+    }
+
+    std::size_t nrOfVertices() const
+    {
+        return this->mVerticesNumber;
+    }
+    // zwraca pamięć zajmowaną przez macierze odległości i poprzedników (w bajtach)
+    std::size_t memoryUsage() const
+    {
+        return this->mDistance.size()*sizeof(T)+this->mPrecursor.size()*sizeof(std::uint32_t);
+    }
+private:
+    static constexpr T INF = std::numeric_limits<T>::infinity();
+
+    std::size_t mVerticesNumber;
+    std::size_t mStride;
+    std::vector<T> mDistance;
+    // mPrecursor[u][v] - wierzchołek poprzedzający "v" na najkrótszej ścieżce z "u"
+    std::vector<std::uint32_t> mPrecursor;
+
+    void mRelaxTile(std::size_t ib, std::size_t jb, std::size_t kb);
+
+    void mCheckVertex(std::size_t vertex_id) const
+    {
+        if(vertex_id>=this->mVerticesNumber)
+        {
+            throw std::runtime_error("[Floyd-Warshall] Incorrect vertex index: "
+                                     +std::to_string(vertex_id));
+        }
+    }
+};
+
+template<typename T>
+template<typename V, typename E>
+AllPairsShortestPaths<T>::AllPairsShortestPaths(const Graph<V, E>& graph,
+                                                std::function<double(const typename Graph<V, E>::edge_type&)> getEdgeLength,
+                                                std::size_t threadsNumber)
+    :mVerticesNumber(graph.nrOfVertices()),
+      mStride((graph.nrOfVertices()+TILE-1)/TILE*TILE)
+{
+    if(this->mVerticesNumber>=NO_PRECURSOR)
+    {
+        throw std::runtime_error("[Floyd-Warshall] Too many vertices: "
+                                 +std::to_string(this->mVerticesNumber));
+    }
+
+    this->mDistance.assign(this->mStride*this->mStride,INF);
+    this->mPrecursor.assign(this->mStride*this->mStride,NO_PRECURSOR);
+
+    for(std::size_t y=0;y<this->mVerticesNumber;++y)
+    {
+        this->mDistance[y*this->mStride+y] = 0;
+        this->mPrecursor[y*this->mStride+y] = static_cast<std::uint32_t>(y);
+
+        for(std::size_t x=0;x<this->mVerticesNumber;++x)
+        {
+            if(graph.edgeExist(y,x))
+            {
+                T length = static_cast<T>(getEdgeLength(graph.edgeLabel(y,x)));
+                if(length < this->mDistance[y*this->mStride+x])
+                {
+                    this->mDistance[y*this->mStride+x] = length;
+                    this->mPrecursor[y*this->mStride+x] = static_cast<std::uint32_t>(y);
+                }
+            }
+        }
+    }
+
+    const std::size_t tiles = this->mStride/TILE;
+    for(std::size_t kb=0;kb<tiles;++kb)
+    {
+        this->mRelaxTile(kb,kb,kb);
+
+        parallelFor(0,2*tiles,[&](std::size_t t)
+        {
+            std::size_t other = t/2;
+            if(other==kb)return;
+            if(t%2==0)this->mRelaxTile(kb,other,kb);
+            else this->mRelaxTile(other,kb,kb);
+        },threadsNumber);
+
+        parallelFor(0,tiles*tiles,[&](std::size_t t)
+        {
+            std::size_t ib = t/tiles;
+            std::size_t jb = t%tiles;
+            if(ib==kb||jb==kb)return;
+            this->mRelaxTile(ib,jb,kb);
+        },threadsNumber);
+    }
+}
+
+template<typename T>
+void AllPairsShortestPaths<T>::mRelaxTile(std::size_t ib, std::size_t jb, std::size_t kb)
+{
+    const std::size_t stride = this->mStride;
+    const std::size_t i0 = ib*TILE, j0 = jb*TILE, k0 = kb*TILE;
+
+    for(std::size_t k=k0;k<k0+TILE;++k)
+    {
+        const T* dk = this->mDistance.data()+k*stride+j0;
+        const std::uint32_t* pk = this->mPrecursor.data()+k*stride+j0;
+
+        for(std::size_t i=i0;i<i0+TILE;++i)
+        {
+            // wiersz "k" poprawiony przez samego siebie nie zmienia się (poza ujemnymi cyklami)
+            if(i==k)continue;
+
+            const T dik = this->mDistance[i*stride+k];
+            if(dik==INF)continue;
+
+            minPlusRow(dik,dk,pk,this->mDistance.data()+i*stride+j0,
+                       this->mPrecursor.data()+i*stride+j0,TILE);
+        }
+    }
+}
+
+template<typename T>
+std::vector<std::size_t> AllPairsShortestPaths<T>::path(std::size_t u, std::size_t v) const
+{
+    this->mCheckVertex(u);
+    this->mCheckVertex(v);
+
+    std::vector<std::size_t> result;
+    if(this->mDistance[u*this->mStride+v]==INF)return result;
+
+    std::size_t current = v;
+    result.push_back(current);
+    while(current!=u)
+    {
+        if(result.size()>this->mVerticesNumber)
+        {
+            throw std::runtime_error("[Floyd-Warshall] Negative cycle on path from "
+                                     +std::to_string(u)+" to "+std::to_string(v));
+        }
+        current = this->mPrecursor[u*this->mStride+current];
+        result.push_back(current);
+    }
+
+    std::reverse(result.begin(),result.end());
+    return result;
+}
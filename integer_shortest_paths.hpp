@@ -0,0 +1,237 @@
+#pragma once
+#include "Graph.hpp"
+#include "BitMatrix.hpp"
+#include "tracing.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// najkrótsze ścieżki dla całkowitych, nieujemnych długości krawędzi (np. sekundy, metry)
+// wyjmowane odległości nigdy nie maleją, więc zamiast kopca binarnego wystarcza kolejka monotoniczna:
+// - kolejka kubełkowa Diala - cykliczna tablica C+1 kubełków (C - największa długość krawędzi),
+//   O(E + D), gdzie D - długość najdłuższej znalezionej ścieżki
+// - kopiec pozycyjny (radix heap) - 65 kubełków według najstarszego bitu, którym klucz różni się od
+//   ostatnio wyjętego, O(E + V log C)
+enum class IntegerQueue
+{
+    // kolejka Diala gdy C <= "DialQueue::MAX_WEIGHT", w przeciwnym razie kopiec pozycyjny
+    Automatic,
+    Dial,
+    Radix
+};
+
+// kolejka kubełkowa Diala - klucz wstawianego wierzchołka musi należeć do
+// [ostatnio wyjęty klucz, ostatnio wyjęty klucz + maxWeight]
+class DialQueue
+{
+public:
+    // dla większych długości krawędzi przeglądanie pustych kubełków kosztuje więcej niż kopiec pozycyjny
+    static constexpr std::uint64_t MAX_WEIGHT = 4096;
+
+    explicit DialQueue(std::uint64_t maxWeight)
+        :mBuckets(maxWeight+1),mCurrent(0),mSize(0)
+    {
+
+    }
+    bool empty() const
+    {
+        return this->mSize==0;
+    }
+    void push(std::uint64_t key, std::size_t vertex)
+    {
+        this->mBuckets[key%this->mBuckets.size()].push_back(vertex);
+        ++this->mSize;
+    }
+    // zwraca (klucz, wierzchołek) o najmniejszym kluczu
+    std::pair<std::uint64_t, std::size_t> pop()
+    {
+        std::size_t i = this->mCurrent%this->mBuckets.size();
+        while(this->mBuckets[i].empty())
+        {
+            ++this->mCurrent;
+            if(++i==this->mBuckets.size())i = 0;
+        }
+        const std::size_t vertex = this->mBuckets[i].back();
+        this->mBuckets[i].pop_back();
+        --this->mSize;
+        return std::make_pair(this->mCurrent,vertex);
+    }
+private:
+    std::vector<std::vector<std::size_t>> mBuckets;
+    std::uint64_t mCurrent;
+    std::size_t mSize;
+};
+
+// kopiec pozycyjny - klucz wstawianego wierzchołka nie może być mniejszy niż ostatnio wyjęty klucz
+// kubełek "i" > 0 zawiera klucze, których najstarszy bit różny od ostatnio wyjętego klucza ma numer i-1
+class RadixHeap
+{
+public:
+    RadixHeap()
+        :mLast(0),mSize(0)
+    {
+
+    }
+    bool empty() const
+    {
+        return this->mSize==0;
+    }
+    void push(std::uint64_t key, std::size_t vertex)
+    {
+        this->mBuckets[this->mBucket(key)].emplace_back(key,vertex);
+        ++this->mSize;
+    }
+    // zwraca (klucz, wierzchołek) o najmniejszym kluczu
+    std::pair<std::uint64_t, std::size_t> pop()
+    {
+        if(this->mBuckets[0].empty())
+        {
+            // najmniejszy klucz pierwszego niepustego kubełka staje się ostatnim kluczem -
+            // pozostałe klucze tego kubełka trafiają do kubełków o mniejszych numerach
+            std::size_t i = 1;
+            while(this->mBuckets[i].empty())++i;
+            this->mLast = std::min_element(this->mBuckets[i].begin(),this->mBuckets[i].end())->first;
+            for(const auto& entry: this->mBuckets[i])
+            {
+                this->mBuckets[this->mBucket(entry.first)].push_back(entry);
+            }
+            this->mBuckets[i].clear();
+        }
+        const std::pair<std::uint64_t, std::size_t> entry = this->mBuckets[0].back();
+        this->mBuckets[0].pop_back();
+        --this->mSize;
+        return entry;
+    }
+private:
+    std::array<std::vector<std::pair<std::uint64_t, std::size_t>>, 65> mBuckets;
+    std::uint64_t mLast;
+    std::size_t mSize;
+
+    std::size_t mBucket(std::uint64_t key) const
+    {
+        return key==this->mLast ? 0 : bitScanReverse(key^this->mLast)+1;
+    }
+};
+
+// przebieg szukania na listach sąsiedztwa (CSR) z kolejką "Queue" (nieaktualne wpisy kolejki są pomijane)
+template<typename Queue>
+void integerShortestPathSearch(const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& targets,
+                               const std::vector<std::uint64_t>& weights, Queue& queue, std::size_t start_idx,
+                               std::size_t end_idx, std::vector<std::uint64_t>& distance,
+                               std::vector<std::size_t>& precursor)
+{
+    constexpr std::uint64_t MAX_VALUE = std::numeric_limits<std::uint64_t>::max();
+    distance[start_idx] = 0;
+    queue.push(0,start_idx);
+    while(!queue.empty())
+    {
+        const auto [key, vId] = queue.pop();
+        if(key!=distance[vId])continue;
+        if(vId==end_idx)break;
+        for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+        {
+            if(weights[i]>=MAX_VALUE-key)
+            {
+                throw std::runtime_error("[Integer shortest paths] Distance overflow");
+            }
+            const std::uint64_t newDistance = key+weights[i];
+            if(newDistance<distance[targets[i]])
+            {
+                distance[targets[i]] = newDistance;
+                precursor[targets[i]] = vId;
+                queue.push(newDistance,targets[i]);
+            }
+        }
+    }
+}
+
+// drzewo najkrótszych ścieżek z "start_idx" - zwraca (odległości, poprzednicy)
+// nieosiągalne wierzchołki mają odległość std::numeric_limits<std::uint64_t>::max(),
+// poprzednikiem startu i wierzchołków nieosiągalnych jest "nrOfVertices()"
+// jeśli podano "end_idx", szukanie kończy się po ustaleniu jego odległości (pozostałe wyniki są wtedy niepełne)
+template<typename V, typename E>
+std::pair<std::vector<std::uint64_t>, std::vector<std::size_t>>
+integerShortestPathTree(const Graph<V, E>& graph, std::size_t start_idx,
+                        std::function<std::size_t(const typename Graph<V, E>::edge_type&)> metric =
+                        [](const E&edge)->std::size_t{return edge;},
+                        IntegerQueue queue = IntegerQueue::Automatic,
+                        std::optional<std::size_t> end_idx = std::nullopt)
+{
+    GRAPH_TRACE_SPAN(span,"query","integer shortest paths: setup");
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(start_idx>=verticesNumber||end_idx.value_or(start_idx)>=verticesNumber)
+    {
+        std::size_t var1 = std::max(start_idx,end_idx.value_or(start_idx));
+        throw std::runtime_error("[Integer shortest paths] Incorrect vertex index: "
+                                 +std::to_string(var1));
+    }
+
+    // listy sąsiedztwa (CSR) z długościami krawędzi
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    for(std::size_t v=0;v<verticesNumber;++v) offsets[v+1] = offsets[v]+graph.outDegree(v);
+    std::vector<std::size_t> targets(offsets[verticesNumber]);
+    std::vector<std::uint64_t> weights(offsets[verticesNumber]);
+    std::uint64_t maxWeight = 0;
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        std::size_t i = offsets[y];
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1),++i)
+        {
+            targets[i] = x;
+            weights[i] = metric(graph.edgeLabel(y,x));
+            maxWeight = std::max(maxWeight,weights[i]);
+        }
+    }
+
+    std::pair<std::vector<std::uint64_t>, std::vector<std::size_t>> result(
+                std::vector<std::uint64_t>(verticesNumber,std::numeric_limits<std::uint64_t>::max()),
+                std::vector<std::size_t>(verticesNumber,verticesNumber));
+    if(queue==IntegerQueue::Automatic)
+    {
+        queue = maxWeight<=DialQueue::MAX_WEIGHT ? IntegerQueue::Dial : IntegerQueue::Radix;
+    }
+
+    GRAPH_TRACE_NEXT(span,"integer shortest paths: search");
+    const std::size_t stop = end_idx.value_or(verticesNumber);
+    if(queue==IntegerQueue::Dial)
+    {
+        DialQueue dial(maxWeight);
+        integerShortestPathSearch(offsets,targets,weights,dial,start_idx,stop,result.first,result.second);
+    }
+    else
+    {
+        RadixHeap heap;
+        integerShortestPathSearch(offsets,targets,weights,heap,start_idx,stop,result.first,result.second);
+    }
+    return result;
+}
+
+// najkrótsza ścieżka z "start_idx" do "end_idx" - zwraca (długość, id wierzchołków ścieżki),
+// lub (std::numeric_limits<std::uint64_t>::max(), {}) gdy ścieżki nie ma
+template<typename V, typename E>
+std::pair<std::uint64_t, std::vector<std::size_t>>
+integerDijkstra(const Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx,
+                std::function<std::size_t(const typename Graph<V, E>::edge_type&)> metric =
+                [](const E&edge)->std::size_t{return edge;},
+                IntegerQueue queue = IntegerQueue::Automatic)
+{
+    auto [distance, precursor] = integerShortestPathTree(graph,start_idx,metric,queue,
+                                                         std::optional<std::size_t>(end_idx));
+    if(distance[end_idx]==std::numeric_limits<std::uint64_t>::max())
+    {
+        return std::make_pair(distance[end_idx],std::vector<std::size_t>());
+    }
+
+    GRAPH_TRACE_SPAN(span,"query","integer shortest paths: path reconstruction");
+    std::vector<std::size_t> result;
+    for(std::size_t v=end_idx;v!=start_idx;v=precursor[v]) result.push_back(v);
+    result.push_back(start_idx);
+    std::reverse(result.begin(),result.end());
+    return std::make_pair(distance[end_idx],result);
+}
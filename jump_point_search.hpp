@@ -0,0 +1,243 @@
+#pragma once
+#include "GridGraph.hpp"
+#include <functional>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+// A* po niejawnej siatce - pamięć zależy od liczby odwiedzonych komórek, a nie od rozmiaru siatki
+// przy "interpolate" kolejne wierzchołki zwróconej ścieżki mogą leżeć daleko od siebie na jednej prostej
+// lub przekątnej i są uzupełniane o komórki pośrednie
+template<typename Expand>
+std::pair<double, std::vector<std::size_t>> gridBestFirstSearch(const GridGraph& grid,
+        std::size_t start_idx, std::size_t end_idx,
+        const std::function<double(const GridGraph&, std::size_t, std::size_t)>& heuristics,
+        Expand expand, bool interpolate)
+{
+    constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+    const std::size_t verticesNumber = grid.nrOfVertices();
+
+    if(start_idx>=verticesNumber|| end_idx>=verticesNumber)
+    {
+        std::size_t var1 = std::max(start_idx,end_idx);
+        throw std::runtime_error("[Grid search] Incorrect vertex index: "
+                                 +std::to_string(var1));
+    }
+    if(!grid.passable(start_idx)||!grid.passable(end_idx))
+    {
+        return std::make_pair(MAX_DOUBLE_VALUE,std::vector<std::size_t>());
+    }
+
+    class GridSearchNode
+    {
+    public:
+        double gScore;
+        std::size_t precursor;
+        bool closed;
+    };
+
+    std::unordered_map<std::size_t, GridSearchNode> nodes;
+    nodes.emplace(start_idx,GridSearchNode{0.,start_idx,false});
+
+    using QueueEntry = std::pair<double, std::size_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openSet;
+    openSet.emplace(heuristics(grid,start_idx,end_idx),start_idx);
+
+    bool found = false;
+    while(!openSet.empty())
+    {
+        const std::size_t current_node = openSet.top().second;
+        openSet.pop();
+
+        GridSearchNode& node = nodes[current_node];
+        if(node.closed)continue;
+        node.closed = true;
+
+        if(current_node==end_idx)
+        {
+            found = true;
+            break;
+        }
+
+        const double gScore = node.gScore;
+        const std::size_t precursor = node.precursor;
+
+        expand(current_node,precursor,[&](std::size_t neighbor, double cost)
+        {
+            auto it = nodes.try_emplace(neighbor,GridSearchNode{MAX_DOUBLE_VALUE,current_node,false}).first;
+            if(it->second.closed)return;
+
+            double tentative_gScore = gScore+cost;
+            if(tentative_gScore < it->second.gScore)
+            {
+                it->second.gScore = tentative_gScore;
+                it->second.precursor = current_node;
+                openSet.emplace(tentative_gScore+heuristics(grid,neighbor,end_idx),neighbor);
+            }
+        });
+    }
+
+    if(!found)
+    {
+        return std::make_pair(MAX_DOUBLE_VALUE,std::vector<std::size_t>());
+    }
+
+    std::vector<std::size_t> path;
+    std::size_t current_node = end_idx;
+    path.push_back(current_node);
+    while(current_node!=start_idx)
+    {
+        std::size_t precursor = nodes[current_node].precursor;
+        if(interpolate)
+        {
+            auto [x1, y1] = grid.coordinates(current_node);
+            auto [x2, y2] = grid.coordinates(precursor);
+            std::ptrdiff_t dx = (x2>x1)-(x2<x1);
+            std::ptrdiff_t dy = (y2>y1)-(y2<y1);
+            std::ptrdiff_t step = dy*static_cast<std::ptrdiff_t>(grid.width())+dx;
+            for(std::size_t v = current_node+step; v!=precursor; v+=step)
+            {
+                path.push_back(v);
+            }
+        }
+        current_node = precursor;
+        path.push_back(current_node);
+    }
+    std::reverse(path.begin(),path.end());
+
+    return std::make_pair(nodes[end_idx].gScore,path);
+}
+
+// A* na niejawnej siatce, zwraca to samo co "astar()" dla "Graph"
+// heurystyka musi być dopuszczalna, np. GridGraph::octileHeuristics
+inline std::pair<double, std::vector<std::size_t>>
+astar(const GridGraph& grid, std::size_t start_idx, std::size_t end_idx,
+      std::function<double(const GridGraph&, std::size_t actual_vertex_id, std::size_t end_vertex_id)>
+      heuristics = GridGraph::octileHeuristics)
+{
+    return gridBestFirstSearch(grid,start_idx,end_idx,heuristics,
+                               [&grid](std::size_t vertex_id, std::size_t, auto push)
+    {
+        grid.forEachNeighbour(vertex_id,push);
+    },false);
+}
+
+// szuka kolejnego punktu skoku idąc z komórki (x, y) w kierunku (dx, dy)
+inline std::optional<std::pair<std::ptrdiff_t, std::ptrdiff_t>>
+jumpPoint(const GridGraph& grid, std::ptrdiff_t x, std::ptrdiff_t y,
+          std::ptrdiff_t dx, std::ptrdiff_t dy, std::ptrdiff_t endX, std::ptrdiff_t endY)
+{
+    while(true)
+    {
+        if(!grid.walkable(x,y))return std::nullopt;
+        if(x==endX&&y==endY)return std::make_pair(x,y);
+
+        if(dx!=0&&dy!=0)
+        {
+            if(jumpPoint(grid,x+dx,y,dx,0,endX,endY)||jumpPoint(grid,x,y+dy,0,dy,endX,endY))
+            {
+                return std::make_pair(x,y);
+            }
+            if(!grid.walkable(x+dx,y)||!grid.walkable(x,y+dy))return std::nullopt;
+        }
+        else if(dx!=0)
+        {
+            if((grid.walkable(x,y-1)&&!grid.walkable(x-dx,y-1))||
+                    (grid.walkable(x,y+1)&&!grid.walkable(x-dx,y+1)))
+            {
+                return std::make_pair(x,y);
+            }
+        }
+        else
+        {
+            if((grid.walkable(x-1,y)&&!grid.walkable(x-1,y-dy))||
+                    (grid.walkable(x+1,y)&&!grid.walkable(x+1,y-dy)))
+            {
+                return std::make_pair(x,y);
+            }
+        }
+
+        x += dx;
+        y += dy;
+    }
+}
+
+// Jump Point Search - A* na siatce o jednolitym koszcie, który pomija symetryczne ścieżki
+// i dodaje do kolejki tylko punkty skoku; wynik (długość i pełna ścieżka komórka po komórce)
+// jest taki sam jak dla "astar()" z heurystyką octile
+inline std::pair<double, std::vector<std::size_t>>
+jumpPointSearch(const GridGraph& grid, std::size_t start_idx, std::size_t end_idx)
+{
+    const std::ptrdiff_t width = static_cast<std::ptrdiff_t>(grid.width());
+    const std::ptrdiff_t endX = static_cast<std::ptrdiff_t>(end_idx)%width;
+    const std::ptrdiff_t endY = static_cast<std::ptrdiff_t>(end_idx)/width;
+
+    auto expand = [&](std::size_t vertex_id, std::size_t precursor, auto push)
+    {
+        const std::ptrdiff_t x = static_cast<std::ptrdiff_t>(vertex_id)%width;
+        const std::ptrdiff_t y = static_cast<std::ptrdiff_t>(vertex_id)/width;
+
+        std::pair<std::ptrdiff_t, std::ptrdiff_t> directions[8];
+        std::size_t directionsNumber = 0;
+
+        if(precursor==vertex_id)
+        {
+            for(std::ptrdiff_t dy=-1;dy<=1;++dy)
+            {
+                for(std::ptrdiff_t dx=-1;dx<=1;++dx)
+                {
+                    if(dx!=0||dy!=0)directions[directionsNumber++] = std::make_pair(dx,dy);
+                }
+            }
+        }
+        else
+        {
+            const std::ptrdiff_t px = static_cast<std::ptrdiff_t>(precursor)%width;
+            const std::ptrdiff_t py = static_cast<std::ptrdiff_t>(precursor)/width;
+            const std::ptrdiff_t dx = (x>px)-(x<px);
+            const std::ptrdiff_t dy = (y>py)-(y<py);
+
+            if(dx!=0&&dy!=0)
+            {
+                directions[directionsNumber++] = std::make_pair(dx,std::ptrdiff_t(0));
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(0),dy);
+                directions[directionsNumber++] = std::make_pair(dx,dy);
+            }
+            else if(dx!=0)
+            {
+                directions[directionsNumber++] = std::make_pair(dx,std::ptrdiff_t(0));
+                directions[directionsNumber++] = std::make_pair(dx,std::ptrdiff_t(1));
+                directions[directionsNumber++] = std::make_pair(dx,std::ptrdiff_t(-1));
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(0),std::ptrdiff_t(1));
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(0),std::ptrdiff_t(-1));
+            }
+            else
+            {
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(0),dy);
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(1),dy);
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(-1),dy);
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(1),std::ptrdiff_t(0));
+                directions[directionsNumber++] = std::make_pair(std::ptrdiff_t(-1),std::ptrdiff_t(0));
+            }
+        }
+
+        for(std::size_t i=0;i<directionsNumber;++i)
+        {
+            const auto [dx, dy] = directions[i];
+            if(!grid.walkable(x+dx,y+dy))continue;
+            if(dx!=0&&dy!=0&&(!grid.walkable(x+dx,y)||!grid.walkable(x,y+dy)))continue;
+
+            auto jump = jumpPoint(grid,x+dx,y+dy,dx,dy,endX,endY);
+            if(jump.has_value())
+            {
+                const auto [jx, jy] = jump.value();
+                const double steps = static_cast<double>(std::max(std::abs(jx-x),std::abs(jy-y)));
+                push(static_cast<std::size_t>(jy*width+jx),(dx!=0&&dy!=0) ? steps*std::sqrt(2.) : steps);
+            }
+        }
+    };
+
+    return gridBestFirstSearch(grid,start_idx,end_idx,GridGraph::octileHeuristics,expand,true);
+}
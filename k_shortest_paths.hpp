@@ -0,0 +1,227 @@
+#pragma once
+#include "Graph.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+#include <tuple>
+
+// k najkrótszych ścieżek bez cykli z "start_idx" do "end_idx" (algorytm Yena z modyfikacją Lawlera)
+// zwraca do "k" par (długość, id wierzchołków ścieżki), od najkrótszej; długości krawędzi muszą być nieujemne
+// - graf jest raz zamieniany na listy sąsiedztwa, a wierzchołki i krawędzie są wykluczane ze szukania
+//   znacznikami, bez kopiowania grafu
+// - tablice szukania są wspólne dla wszystkich szukań odgałęzień (czyszczone przez zmianę znacznika)
+// - odgałęzienia ścieżki są szukane tylko od miejsca, w którym odeszła od ścieżki-rodzica, a długości
+//   prefiksów są liczone raz dla każdej ścieżki
+// - szukania odgałęzień to A* z dokładnymi odległościami do celu w pełnym grafie jako heurystyką
+template<typename V, typename E>
+std::vector<std::pair<double, std::vector<std::size_t>>>
+kShortestPaths(const Graph<V, E>& graph, std::size_t start_idx, std::size_t end_idx, std::size_t k,
+               std::function<double(const E&)> getEdgeLength =
+               [](const E&edge)->double{return edge;})
+{
+    constexpr double MAX_DOUBLE_VALUE = std::numeric_limits<double>::max();
+    const std::size_t verticesNumber = graph.nrOfVertices();
+
+    if(start_idx>=verticesNumber|| end_idx>=verticesNumber)
+    {
+        std::size_t var1 = std::max(start_idx,end_idx);
+        throw std::runtime_error("[K shortest paths] Incorrect vertex index: "
+                                 +std::to_string(var1));
+    }
+
+    std::vector<std::pair<double, std::vector<std::size_t>>> result;
+    if(k==0)return result;
+
+    // listy sąsiedztwa (CSR) w obu kierunkach
+    std::vector<std::size_t> offsets(verticesNumber+1,0), reverseOffsets(verticesNumber+1,0);
+    std::vector<std::pair<std::size_t, double>> arcs, reverseArcs;
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            double length = getEdgeLength(graph.edgeLabel(y,x));
+            if(length<0)
+            {
+                throw std::runtime_error("[K shortest paths] Negative edge length: "
+                                         +std::to_string(y)+" -> "+std::to_string(x));
+            }
+            arcs.emplace_back(x,length);
+            ++reverseOffsets[x+1];
+        }
+        offsets[y+1] = arcs.size();
+    }
+    for(std::size_t v=0;v<verticesNumber;++v) reverseOffsets[v+1] += reverseOffsets[v];
+    reverseArcs.resize(arcs.size());
+    {
+        std::vector<std::size_t> fill(reverseOffsets.begin(),reverseOffsets.end()-1);
+        for(std::size_t y=0;y<verticesNumber;++y)
+        {
+            for(std::size_t i=offsets[y];i<offsets[y+1];++i)
+            {
+                reverseArcs[fill[arcs[i].first]++] = std::make_pair(y,arcs[i].second);
+            }
+        }
+    }
+
+    using QueueEntry = std::pair<double, std::size_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> q1;
+
+    // odległości do celu - heurystyka dla szukań odgałęzień (maskowanie tylko je wydłuża)
+    std::vector<double> toEnd(verticesNumber,MAX_DOUBLE_VALUE);
+    toEnd[end_idx] = 0;
+    q1.emplace(0.,end_idx);
+    while(!q1.empty())
+    {
+        auto [distance, vId] = q1.top();
+        q1.pop();
+        if(distance>toEnd[vId])continue;
+        for(std::size_t i=reverseOffsets[vId];i<reverseOffsets[vId+1];++i)
+        {
+            auto [u, length] = reverseArcs[i];
+            if(distance+length<toEnd[u])
+            {
+                toEnd[u] = distance+length;
+                q1.emplace(toEnd[u],u);
+            }
+        }
+    }
+    if(toEnd[start_idx]==MAX_DOUBLE_VALUE)return result;
+
+    // wspólne tablice szukań, wpis jest ważny tylko gdy jego znacznik równa się "stamp"
+    std::vector<double> gScore(verticesNumber);
+    std::vector<std::size_t> precursor(verticesNumber);
+    std::vector<std::size_t> scoreStamp(verticesNumber,0), closedStamp(verticesNumber,0);
+    std::vector<std::size_t> bannedVertex(verticesNumber,0), bannedSuccessor(verticesNumber,0);
+    std::size_t stamp = 0;
+
+    // A* z "spur" do celu z pominięciem zablokowanych wierzchołków i krawędzi (spur, zablokowany następnik)
+    auto spurSearch = [&](std::size_t spur, std::vector<std::size_t>& path)->double
+    {
+        while(!q1.empty())q1.pop();
+        gScore[spur] = 0;
+        scoreStamp[spur] = stamp;
+        q1.emplace(toEnd[spur],spur);
+
+        while(!q1.empty())
+        {
+            std::size_t vId = q1.top().second;
+            q1.pop();
+            if(closedStamp[vId]==stamp)continue;
+            closedStamp[vId] = stamp;
+
+            if(vId==end_idx)
+            {
+                path.clear();
+                for(std::size_t v=end_idx; v!=spur; v=precursor[v]) path.push_back(v);
+                path.push_back(spur);
+                std::reverse(path.begin(),path.end());
+                return gScore[end_idx];
+            }
+
+            for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+            {
+                auto [x, length] = arcs[i];
+                if(toEnd[x]==MAX_DOUBLE_VALUE||bannedVertex[x]==stamp||closedStamp[x]==stamp)continue;
+                if(vId==spur&&bannedSuccessor[x]==stamp)continue;
+
+                double tentative_gScore = gScore[vId]+length;
+                if(scoreStamp[x]!=stamp||tentative_gScore<gScore[x])
+                {
+                    gScore[x] = tentative_gScore;
+                    scoreStamp[x] = stamp;
+                    precursor[x] = vId;
+                    q1.emplace(tentative_gScore+toEnd[x],x);
+                }
+            }
+        }
+        return MAX_DOUBLE_VALUE;
+    };
+
+    class PathRecord
+    {
+    public:
+        std::vector<std::size_t> path;
+        // prefixLength[i] - długość ścieżki do path[i]
+        std::vector<double> prefixLength;
+        // indeks wierzchołka, w którym ścieżka odeszła od ścieżki-rodzica
+        std::size_t deviation;
+    };
+    auto makeRecord = [&](std::vector<std::size_t> path, std::size_t deviation)
+    {
+        PathRecord record{std::move(path),{},deviation};
+        record.prefixLength.resize(record.path.size());
+        record.prefixLength[0] = 0;
+        for(std::size_t i=1;i<record.path.size();++i)
+        {
+            const std::size_t y = record.path[i-1];
+            const std::size_t x = record.path[i];
+            double length = MAX_DOUBLE_VALUE;
+            for(std::size_t j=offsets[y];j<offsets[y+1];++j)
+            {
+                if(arcs[j].first==x)
+                {
+                    length = arcs[j].second;
+                    break;
+                }
+            }
+            record.prefixLength[i] = record.prefixLength[i-1]+length;
+        }
+        return record;
+    };
+
+    std::vector<PathRecord> accepted;
+    // kandydaci (długość, ścieżka, miejsce odejścia od rodzica), najkrótszy pierwszy
+    std::set<std::tuple<double, std::vector<std::size_t>, std::size_t>> candidates;
+    std::set<std::vector<std::size_t>> known;
+
+    {
+        ++stamp;
+        std::vector<std::size_t> path;
+        spurSearch(start_idx,path);
+        known.insert(path);
+        accepted.push_back(makeRecord(std::move(path),0));
+    }
+
+    std::vector<std::size_t> spurPath;
+    while(accepted.size()<k)
+    {
+        const PathRecord& previous = accepted.back();
+        for(std::size_t i=previous.deviation;i+1<previous.path.size();++i)
+        {
+            ++stamp;
+            const std::size_t spur = previous.path[i];
+            for(std::size_t j=0;j<i;++j) bannedVertex[previous.path[j]] = stamp;
+            for(const PathRecord& p: accepted)
+            {
+                if(p.path.size()>i+1 && std::equal(p.path.begin(),p.path.begin()+i+1,previous.path.begin()))
+                {
+                    bannedSuccessor[p.path[i+1]] = stamp;
+                }
+            }
+
+            double spurLength = spurSearch(spur,spurPath);
+            if(spurLength==MAX_DOUBLE_VALUE)continue;
+
+            std::vector<std::size_t> path(previous.path.begin(),previous.path.begin()+i);
+            path.insert(path.end(),spurPath.begin(),spurPath.end());
+            if(known.insert(path).second)
+            {
+                candidates.emplace(previous.prefixLength[i]+spurLength,std::move(path),i);
+            }
+        }
+
+        if(candidates.empty())break;
+        auto best = candidates.begin();
+        accepted.push_back(makeRecord(std::get<1>(*best),std::get<2>(*best)));
+        candidates.erase(best);
+    }
+
+    result.reserve(accepted.size());
+    for(PathRecord& p: accepted)
+    {
+        result.emplace_back(p.prefixLength.back(),std::move(p.path));
+    }
+    return result;
+}
@@ -0,0 +1,336 @@
+#pragma once
+#include "Graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+
+// minimalne drzewo (las) rozpinające - krawędzie grafu są traktowane jako nieskierowane,
+// pętle są pomijane, a z krawędzi y->x i x->y wybierana jest co najwyżej jedna
+// wszystkie algorytmy zwracają (suma wag, id krawędzi (y, x) lasu rosnąco) - krawędzie o równych wagach
+// są porządkowane po (y, x), więc las jest jednoznaczny i taki sam dla każdego algorytmu
+
+// krawędź kandydująca do drzewa rozpinającego
+class SpanningTreeEdge
+{
+public:
+    double weight;
+    std::size_t y;
+    std::size_t x;
+
+    bool operator<(const SpanningTreeEdge& e) const
+    {
+        if(this->weight!=e.weight)return this->weight<e.weight;
+        if(this->y!=e.y)return this->y<e.y;
+        return this->x<e.x;
+    }
+};
+
+// zbiory rozłączne z kompresją ścieżek (połowienie) i łączeniem według rozmiaru
+class DisjointSets
+{
+public:
+    explicit DisjointSets(std::size_t n)
+        :mParent(n),mSize(n,1)
+    {
+        std::iota(this->mParent.begin(),this->mParent.end(),std::size_t(0));
+    }
+
+    std::size_t find(std::size_t v)
+    {
+        while(this->mParent[v]!=v)
+        {
+            this->mParent[v] = this->mParent[this->mParent[v]];
+            v = this->mParent[v];
+        }
+        return v;
+    }
+    // bez kompresji - bezpieczne przy równoległych odczytach
+    std::size_t findConst(std::size_t v) const
+    {
+        while(this->mParent[v]!=v) v = this->mParent[v];
+        return v;
+    }
+    // łączy zbiory "a" i "b", zwraca false jeśli już były połączone
+    bool unite(std::size_t a, std::size_t b)
+    {
+        a = this->find(a);
+        b = this->find(b);
+        if(a==b)return false;
+        if(this->mSize[a]<this->mSize[b])std::swap(a,b);
+        this->mParent[b] = a;
+        this->mSize[a] += this->mSize[b];
+        return true;
+    }
+private:
+    std::vector<std::size_t> mParent;
+    std::vector<std::size_t> mSize;
+};
+
+// zbiera krawędzie grafu (bez pętli) równolegle po wierszach macierzy
+template<typename V, typename E>
+std::vector<SpanningTreeEdge> spanningTreeCandidates(const Graph<V, E>& graph,
+                                                     const std::function<double(const E&)>& getEdgeLength,
+                                                     std::size_t threadsNumber)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    parallelFor(0,verticesNumber,[&](std::size_t y)
+    {
+        std::size_t degree = 0;
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x!=y)++degree;
+        }
+        offsets[y+1] = degree;
+    },threadsNumber,64);
+    std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+
+    std::vector<SpanningTreeEdge> edges(offsets[verticesNumber]);
+    parallelFor(0,verticesNumber,[&](std::size_t y)
+    {
+        std::size_t i = offsets[y];
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x!=y)
+            {
+                edges[i++] = SpanningTreeEdge{getEdgeLength(graph.edgeLabel(y,x)),y,x};
+            }
+        }
+    },threadsNumber,64);
+    return edges;
+}
+
+inline std::pair<double, std::vector<std::pair<std::size_t, std::size_t>>>
+spanningTreeResult(const std::vector<SpanningTreeEdge>& edges, std::vector<std::size_t>& selected)
+{
+    std::sort(selected.begin(),selected.end(),[&](std::size_t a, std::size_t b)
+    {
+        return std::make_pair(edges[a].y,edges[a].x)<std::make_pair(edges[b].y,edges[b].x);
+    });
+
+    std::pair<double, std::vector<std::pair<std::size_t, std::size_t>>> result(0.,{});
+    result.second.reserve(selected.size());
+    for(std::size_t e: selected)
+    {
+        result.first += edges[e].weight;
+        result.second.emplace_back(edges[e].y,edges[e].x);
+    }
+    return result;
+}
+
+// listy sąsiedztwa nieskierowane: dla wierzchołka v - id krawędzi z "edges" o końcu w v
+inline void spanningTreeAdjacency(std::size_t verticesNumber, const std::vector<SpanningTreeEdge>& edges,
+                                  std::vector<std::size_t>& offsets, std::vector<std::size_t>& incident)
+{
+    offsets.assign(verticesNumber+1,0);
+    for(const SpanningTreeEdge& e: edges)
+    {
+        ++offsets[e.y+1];
+        ++offsets[e.x+1];
+    }
+    std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+
+    incident.resize(offsets[verticesNumber]);
+    std::vector<std::size_t> fill(offsets.begin(),offsets.end()-1);
+    for(std::size_t i=0;i<edges.size();++i)
+    {
+        incident[fill[edges[i].y]++] = i;
+        incident[fill[edges[i].x]++] = i;
+    }
+}
+
+// algorytm Prima z kopcem indeksowanym (zmniejszanie klucza w miejscu), O(E log V)
+template<typename V, typename E>
+std::pair<double, std::vector<std::pair<std::size_t, std::size_t>>>
+primMinimumSpanningTree(const Graph<V, E>& graph,
+                        std::function<double(const E&)> getEdgeLength =
+                        [](const E&edge)->double{return edge;},
+                        std::size_t threadsNumber = 0)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    std::vector<SpanningTreeEdge> edges = spanningTreeCandidates(graph,getEdgeLength,threadsNumber);
+    std::vector<std::size_t> offsets, incident;
+    spanningTreeAdjacency(verticesNumber,edges,offsets,incident);
+
+    // kopiec wierzchołków po najlepszej krawędzi łączącej je z drzewem
+    std::vector<std::size_t> heap;
+    std::vector<std::size_t> position(verticesNumber,NONE);
+    std::vector<std::size_t> bestEdge(verticesNumber,NONE);
+    std::vector<bool> inTree(verticesNumber,false);
+
+    auto less = [&](std::size_t a, std::size_t b)
+    {
+        return edges[bestEdge[heap[a]]]<edges[bestEdge[heap[b]]];
+    };
+    auto swapNodes = [&](std::size_t a, std::size_t b)
+    {
+        std::swap(heap[a],heap[b]);
+        position[heap[a]] = a;
+        position[heap[b]] = b;
+    };
+    auto siftUp = [&](std::size_t i)
+    {
+        while(i>0&&less(i,(i-1)/2))
+        {
+            swapNodes(i,(i-1)/2);
+            i = (i-1)/2;
+        }
+    };
+    auto siftDown = [&](std::size_t i)
+    {
+        while(true)
+        {
+            std::size_t smallest = i;
+            for(std::size_t c=2*i+1;c<=2*i+2&&c<heap.size();++c)
+            {
+                if(less(c,smallest))smallest = c;
+            }
+            if(smallest==i)break;
+            swapNodes(i,smallest);
+            i = smallest;
+        }
+    };
+
+    std::vector<std::size_t> selected;
+    for(std::size_t root=0;root<verticesNumber;++root)
+    {
+        if(inTree[root])continue;
+
+        std::size_t vId = root;
+        while(true)
+        {
+            inTree[vId] = true;
+            for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+            {
+                const std::size_t e = incident[i];
+                const std::size_t u = edges[e].y==vId ? edges[e].x : edges[e].y;
+                if(inTree[u])continue;
+                if(position[u]==NONE)
+                {
+                    bestEdge[u] = e;
+                    position[u] = heap.size();
+                    heap.push_back(u);
+                    siftUp(position[u]);
+                }
+                else if(edges[e]<edges[bestEdge[u]])
+                {
+                    bestEdge[u] = e;
+                    siftUp(position[u]);
+                }
+            }
+
+            if(heap.empty())break;
+            vId = heap.front();
+            selected.push_back(bestEdge[vId]);
+            swapNodes(0,heap.size()-1);
+            heap.pop_back();
+            position[vId] = NONE;
+            if(!heap.empty())siftDown(0);
+        }
+    }
+
+    return spanningTreeResult(edges,selected);
+}
+
+// algorytm Kruskala: krawędzie sortowane równolegle, potem zbiory rozłączne
+template<typename V, typename E>
+std::pair<double, std::vector<std::pair<std::size_t, std::size_t>>>
+kruskalMinimumSpanningTree(const Graph<V, E>& graph,
+                           std::function<double(const E&)> getEdgeLength =
+                           [](const E&edge)->double{return edge;},
+                           std::size_t threadsNumber = 0)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    std::vector<SpanningTreeEdge> edges = spanningTreeCandidates(graph,getEdgeLength,threadsNumber);
+    parallelSort(edges.begin(),edges.end(),std::less<SpanningTreeEdge>(),threadsNumber);
+
+    DisjointSets sets(verticesNumber);
+    std::vector<std::size_t> selected;
+    for(std::size_t i=0;i<edges.size()&&selected.size()+1<verticesNumber;++i)
+    {
+        if(sets.unite(edges[i].y,edges[i].x))selected.push_back(i);
+    }
+
+    return spanningTreeResult(edges,selected);
+}
+
+// algorytm Borůvki: w każdej rundzie każda składowa równolegle wybiera najlżejszą krawędź wychodzącą,
+// a wybrane krawędzie łączą składowe - najwyżej log2(V) rund
+template<typename V, typename E>
+std::pair<double, std::vector<std::pair<std::size_t, std::size_t>>>
+boruvkaMinimumSpanningTree(const Graph<V, E>& graph,
+                           std::function<double(const E&)> getEdgeLength =
+                           [](const E&edge)->double{return edge;},
+                           std::size_t threadsNumber = 0)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    std::vector<SpanningTreeEdge> edges = spanningTreeCandidates(graph,getEdgeLength,threadsNumber);
+    std::vector<std::size_t> offsets, incident;
+    spanningTreeAdjacency(verticesNumber,edges,offsets,incident);
+
+    DisjointSets sets(verticesNumber);
+    std::vector<std::size_t> component(verticesNumber);
+    std::iota(component.begin(),component.end(),std::size_t(0));
+    std::unique_ptr<std::atomic<std::size_t>[]> best(new std::atomic<std::size_t>[verticesNumber]);
+    std::vector<std::size_t> selected;
+
+    while(true)
+    {
+        parallelFor(0,verticesNumber,[&](std::size_t v)
+        {
+            best[v].store(NONE,std::memory_order_relaxed);
+        },threadsNumber,1024);
+
+        parallelFor(0,verticesNumber,[&](std::size_t v)
+        {
+            const std::size_t c = component[v];
+            std::size_t local = NONE;
+            for(std::size_t i=offsets[v];i<offsets[v+1];++i)
+            {
+                const std::size_t e = incident[i];
+                const std::size_t u = edges[e].y==v ? edges[e].x : edges[e].y;
+                if(component[u]!=c)
+                {
+                    if(local==NONE||edges[e]<edges[local])local = e;
+                }
+            }
+            if(local==NONE)return;
+
+            std::size_t current = best[c].load(std::memory_order_relaxed);
+            while((current==NONE||edges[local]<edges[current]) &&
+                  !best[c].compare_exchange_weak(current,local,std::memory_order_relaxed))
+            {
+
+            }
+        },threadsNumber,256);
+
+        // łączenie jest sekwencyjne - dotyczy tylko składowych, nie wierzchołków
+        bool merged = false;
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            const std::size_t e = best[v].load(std::memory_order_relaxed);
+            if(e!=NONE&&sets.unite(edges[e].y,edges[e].x))
+            {
+                selected.push_back(e);
+                merged = true;
+            }
+        }
+        if(!merged)break;
+
+        parallelFor(0,verticesNumber,[&](std::size_t v)
+        {
+            component[v] = sets.findConst(v);
+        },threadsNumber,1024);
+    }
+
+    return spanningTreeResult(edges,selected);
+}
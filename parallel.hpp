@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// zwraca liczbę wątków do użycia - 0 oznacza wszystkie dostępne rdzenie
+inline std::size_t threadsNumberOrDefault(std::size_t threadsNumber)
+{
+    if(threadsNumber==0)
+    {
+        threadsNumber = std::thread::hardware_concurrency();
+    }
+    return std::max<std::size_t>(threadsNumber,1);
+}
+
+// wywołuje "f(i)" dla każdego i z przedziału [begin, end) na "threadsNumber" wątkach
+// indeksy są rozdzielane dynamicznie porcjami po "chunk", f(i) dla różnych i musi być niezależne
+// pierwszy wyjątek zgłoszony w którymkolwiek wątku jest przekazywany dalej po zakończeniu pracy
+inline void parallelFor(std::size_t begin, std::size_t end,
+                        const std::function<void(std::size_t)>& f,
+                        std::size_t threadsNumber = 0, std::size_t chunk = 1)
+{
+    if(begin>=end)return;
+
+    chunk = std::max<std::size_t>(chunk,1);
+    threadsNumber = std::min(threadsNumberOrDefault(threadsNumber),(end-begin+chunk-1)/chunk);
+
+    if(threadsNumber==1)
+    {
+        for(std::size_t i=begin;i<end;++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next(begin);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            while(true)
+            {
+                std::size_t first = next.fetch_add(chunk);
+                if(first>=end)break;
+
+                std::size_t last = std::min(end,first+chunk);
+                for(std::size_t i=first;i<last;++i)
+                {
+                    f(i);
+                }
+            }
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if(!error)error = std::current_exception();
+            next = end;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsNumber-1);
+    for(std::size_t i=1;i<threadsNumber;++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& t: threads)
+    {
+        t.join();
+    }
+
+    if(error)std::rethrow_exception(error);
+}
+
+// sortuje [first, last) na "threadsNumber" wątkach: porcje są sortowane niezależnie, a potem scalane parami
+template<typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, std::size_t threadsNumber = 0)
+{
+    const std::size_t n = static_cast<std::size_t>(last-first);
+    constexpr std::size_t MIN_CHUNK = 1<<14;
+    const std::size_t chunks = std::min(threadsNumberOrDefault(threadsNumber),std::max<std::size_t>(n/MIN_CHUNK,1));
+
+    if(chunks==1)
+    {
+        std::sort(first,last,comp);
+        return;
+    }
+
+    std::vector<std::size_t> bounds(chunks+1);
+    for(std::size_t i=0;i<=chunks;++i) bounds[i] = n*i/chunks;
+
+    parallelFor(0,chunks,[&](std::size_t i)
+    {
+        std::sort(first+bounds[i],first+bounds[i+1],comp);
+    },threadsNumber);
+
+    for(std::size_t width=1;width<chunks;width*=2)
+    {
+        parallelFor(0,(chunks+2*width-1)/(2*width),[&](std::size_t pair)
+        {
+            const std::size_t left = pair*2*width;
+            const std::size_t middle = std::min(left+width,chunks);
+            const std::size_t right = std::min(left+2*width,chunks);
+            if(middle<right)
+            {
+                std::inplace_merge(first+bounds[left],first+bounds[middle],first+bounds[right],comp);
+            }
+        },threadsNumber);
+    }
+}
@@ -0,0 +1,393 @@
+#pragma once
+#include "Graph.hpp"
+#include "BitMatrix.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stack>
+#include <tuple>
+
+// silnie spójne składowe (iteracyjny algorytm Tarjana)
+// zwraca liczbę składowych i numer składowej każdego wierzchołka,
+// składowe są ponumerowane w porządku topologicznym grafu skondensowanego
+// (krawędzie między składowymi prowadzą zawsze od mniejszego numeru do większego)
+template<typename V, typename E>
+std::pair<std::size_t, std::vector<std::size_t>> stronglyConnectedComponents(const Graph<V, E>& graph)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    const std::size_t UNVISITED = verticesNumber;
+
+    std::vector<std::size_t> index(verticesNumber, UNVISITED);
+    std::vector<std::size_t> lowLink(verticesNumber, 0);
+    std::vector<std::size_t> component(verticesNumber, 0);
+    std::vector<std::size_t> nextNeighbour(verticesNumber, 0);
+    std::vector<bool> onStack(verticesNumber, false);
+
+    std::stack<std::size_t> sccStack;
+    std::vector<std::size_t> callStack;
+    std::size_t counter = 0;
+    std::size_t componentsNumber = 0;
+
+    for(std::size_t root=0;root<verticesNumber;++root)
+    {
+        if(index[root]!=UNVISITED)continue;
+
+        index[root] = lowLink[root] = counter++;
+        sccStack.push(root);
+        onStack[root] = true;
+        callStack.push_back(root);
+
+        while(!callStack.empty())
+        {
+            const std::size_t vId = callStack.back();
+            bool descended = false;
+
+            for(std::size_t& i = nextNeighbour[vId]; (i = graph.nextNeighbor(vId,i))<verticesNumber; ++i)
+            {
+                if(index[i]==UNVISITED)
+                {
+                    index[i] = lowLink[i] = counter++;
+                    sccStack.push(i);
+                    onStack[i] = true;
+                    callStack.push_back(i);
+                    ++i;
+                    descended = true;
+                    break;
+                }
+                else if(onStack[i])
+                {
+                    lowLink[vId] = std::min(lowLink[vId],index[i]);
+                }
+            }
+            if(descended)continue;
+
+            if(lowLink[vId]==index[vId])
+            {
+                std::size_t member;
+                do
+                {
+                    member = sccStack.top();
+                    sccStack.pop();
+                    onStack[member] = false;
+                    component[member] = componentsNumber;
+                }while(member!=vId);
+                ++componentsNumber;
+            }
+
+            callStack.pop_back();
+            if(!callStack.empty())
+            {
+                std::size_t parent = callStack.back();
+                lowLink[parent] = std::min(lowLink[parent],lowLink[vId]);
+            }
+        }
+    }
+
+    // Tarjan zamyka składowe w odwrotnym porządku topologicznym
+    for(std::size_t& c: component)
+    {
+        c = componentsNumber-1-c;
+    }
+
+    return std::make_pair(componentsNumber,component);
+}
+
+// następniki każdej składowej w grafie skondensowanym (posortowane rosnąco, bez powtórzeń)
+template<typename V, typename E>
+std::vector<std::vector<std::size_t>> condensationSuccessors(const Graph<V, E>& graph,
+        const std::vector<std::size_t>& component, std::size_t componentsNumber)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    std::vector<std::vector<std::size_t>> successors(componentsNumber);
+
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(component[y]!=component[x])
+            {
+                successors[component[y]].push_back(component[x]);
+            }
+        }
+    }
+
+    for(std::vector<std::size_t>& s: successors)
+    {
+        std::sort(s.begin(),s.end());
+        s.erase(std::unique(s.begin(),s.end()),s.end());
+    }
+    return successors;
+}
+
+// domknięcie przechodnie grafu - pełna macierz bitowa osiągalności między silnie spójnymi składowymi
+// zapytanie "reachable()" w O(1), pamięć O(C^2/8) bajtów dla C składowych
+// migawka - po modyfikacji grafu należy zbudować domknięcie ponownie
+class TransitiveClosure
+{
+public:
+    // szerokość pasa kolumn (w słowach) przetwarzanego naraz - 64 słowa = 4096 kolumn, 512 B na wiersz
+    static constexpr std::size_t BLOCK_WORDS = 64;
+
+    template<typename V, typename E>
+    explicit TransitiveClosure(const Graph<V, E>& graph);
+
+    // zwraca true jeśli z wierzchołka "u" da się dojść do wierzchołka "v" (ścieżka długości 0 też się liczy)
+    bool reachable(std::size_t u, std::size_t v) const
+    {
+        this->mCheckVertex(u);
+        this->mCheckVertex(v);
+        return this->mClosure.test(this->mComponent[u],this->mComponent[v]);
+    }
+
+    std::size_t nrOfVertices() const
+    {
+        return this->mComponent.size();
+    }
+    std::size_t nrOfComponents() const
+    {
+        return this->mClosure.rows();
+    }
+    // zwraca pamięć zajmowaną przez macierz domknięcia (w bajtach)
+    std::size_t memoryUsage() const
+    {
+        return this->mClosure.memoryUsage();
+    }
+private:
+    std::vector<std::size_t> mComponent;
+    BitMatrix mClosure;
+
+    void mCheckVertex(std::size_t vertex_id) const
+    {
+        if(vertex_id>=this->mComponent.size())
+        {
+            throw std::runtime_error("[Transitive closure] Incorrect vertex index: "
+                                     +std::to_string(vertex_id));
+        }
+    }
+};
+
+template<typename V, typename E>
+TransitiveClosure::TransitiveClosure(const Graph<V, E>& graph)
+{
+    std::size_t componentsNumber;
+    std::tie(componentsNumber,this->mComponent) = stronglyConnectedComponents(graph);
+    std::vector<std::vector<std::size_t>> successors =
+            condensationSuccessors(graph,this->mComponent,componentsNumber);
+
+    this->mClosure = BitMatrix(componentsNumber,componentsNumber);
+    for(std::size_t c=0;c<componentsNumber;++c)
+    {
+        this->mClosure.set(c,c);
+    }
+
+    // Wiersz składowej "c" ma bity tylko w kolumnach >= c, więc wiersze składamy od końca porządku
+    // topologicznego. Kolumny przetwarzamy pasami, żeby sumowane fragmenty wierszy mieściły się w cache.
+    // Następniki są przeglądane rosnąco - jeśli w pasie zawierającym następnik "s" jego bit jest już
+    // ustawiony, to "s" jest osiągalny przez wcześniejszy następnik i jest usuwany z listy na dalsze pasy.
+    const std::size_t wordsPerRow = this->mClosure.wordsPerRow();
+    for(std::size_t blockBegin=0;blockBegin<wordsPerRow;blockBegin+=BLOCK_WORDS)
+    {
+        const std::size_t blockEnd = std::min(wordsPerRow,blockBegin+BLOCK_WORDS);
+        const std::size_t firstColumn = blockBegin*BitMatrix::WORD_BITS;
+        const std::size_t endColumn = blockEnd*BitMatrix::WORD_BITS;
+
+        std::size_t c = std::min(componentsNumber,endColumn);
+        while(c>0)
+        {
+            --c;
+            std::uint64_t* row = this->mClosure.row(c);
+            std::vector<std::size_t>& s1 = successors[c];
+            std::size_t kept = 0;
+            for(std::size_t s: s1)
+            {
+                if(s<endColumn)
+                {
+                    if(s>=firstColumn && this->mClosure.test(c,s))continue;
+                    bitsOr(row+blockBegin,this->mClosure.row(s)+blockBegin,blockEnd-blockBegin);
+                }
+                s1[kept++] = s;
+            }
+            s1.resize(kept);
+        }
+    }
+}
+
+// indeks osiągalności oparty o etykiety 2-hop (pruned landmark labeling) dla grafów zbyt dużych
+// na pełne domknięcie - każda składowa przechowuje posortowane listy "punktów przesiadkowych"
+// Lout (osiągalne z niej) i Lin (z których jest osiągalna); u->v istnieje gdy Lout(u) i Lin(v) się przecinają
+class ReachabilityIndex
+{
+public:
+    template<typename V, typename E>
+    explicit ReachabilityIndex(const Graph<V, E>& graph);
+
+    // zwraca true jeśli z wierzchołka "u" da się dojść do wierzchołka "v" (ścieżka długości 0 też się liczy)
+    bool reachable(std::size_t u, std::size_t v) const
+    {
+        this->mCheckVertex(u);
+        this->mCheckVertex(v);
+
+        std::size_t cu = this->mComponent[u];
+        std::size_t cv = this->mComponent[v];
+        if(cu==cv)return true;
+        if(cu>cv)return false;
+
+        return mIntersects(this->mOutLabels.data()+this->mOutOffsets[cu],
+                           this->mOutLabels.data()+this->mOutOffsets[cu+1],
+                           this->mInLabels.data()+this->mInOffsets[cv],
+                           this->mInLabels.data()+this->mInOffsets[cv+1]);
+    }
+
+    std::size_t nrOfVertices() const
+    {
+        return this->mComponent.size();
+    }
+    std::size_t nrOfComponents() const
+    {
+        return this->mOutOffsets.empty() ? 0 : this->mOutOffsets.size()-1;
+    }
+    // zwraca łączną liczbę etykiet
+    std::size_t labelsNumber() const
+    {
+        return this->mOutLabels.size()+this->mInLabels.size();
+    }
+    // zwraca pamięć zajmowaną przez etykiety (w bajtach)
+    std::size_t memoryUsage() const
+    {
+        return this->labelsNumber()*sizeof(std::uint32_t)
+                +(this->mOutOffsets.size()+this->mInOffsets.size())*sizeof(std::size_t);
+    }
+private:
+    std::vector<std::size_t> mComponent;
+    std::vector<std::size_t> mOutOffsets;
+    std::vector<std::uint32_t> mOutLabels;
+    std::vector<std::size_t> mInOffsets;
+    std::vector<std::uint32_t> mInLabels;
+
+    static bool mIntersects(const std::uint32_t* a, const std::uint32_t* aEnd,
+                            const std::uint32_t* b, const std::uint32_t* bEnd)
+    {
+        while(a!=aEnd && b!=bEnd)
+        {
+            if(*a==*b)return true;
+            if(*a<*b)++a;
+            else ++b;
+        }
+        return false;
+    }
+
+    static void mFlatten(const std::vector<std::vector<std::uint32_t>>& labels,
+                         std::vector<std::size_t>& offsets, std::vector<std::uint32_t>& flat)
+    {
+        offsets.assign(1,0);
+        for(const std::vector<std::uint32_t>& l: labels)
+        {
+            flat.insert(flat.end(),l.begin(),l.end());
+            offsets.push_back(flat.size());
+        }
+        flat.shrink_to_fit();
+    }
+
+    void mCheckVertex(std::size_t vertex_id) const
+    {
+        if(vertex_id>=this->mComponent.size())
+        {
+            throw std::runtime_error("[Reachability index] Incorrect vertex index: "
+                                     +std::to_string(vertex_id));
+        }
+    }
+};
+
+template<typename V, typename E>
+ReachabilityIndex::ReachabilityIndex(const Graph<V, E>& graph)
+{
+    std::size_t componentsNumber;
+    std::tie(componentsNumber,this->mComponent) = stronglyConnectedComponents(graph);
+    if(componentsNumber>std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::runtime_error("[Reachability index] Too many components: "
+                                 +std::to_string(componentsNumber));
+    }
+
+    const std::vector<std::vector<std::size_t>> successors =
+            condensationSuccessors(graph,this->mComponent,componentsNumber);
+    std::vector<std::vector<std::size_t>> predecessors(componentsNumber);
+    for(std::size_t c=0;c<componentsNumber;++c)
+    {
+        for(std::size_t s: successors[c])
+        {
+            predecessors[s].push_back(c);
+        }
+    }
+
+    // najpierw składowe o największej liczbie ścieżek przez nie przechodzących
+    std::vector<std::size_t> order(componentsNumber);
+    for(std::size_t c=0;c<componentsNumber;++c)
+    {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(),order.end(),[&](std::size_t a, std::size_t b)
+    {
+        return (successors[a].size()+1)*(predecessors[a].size()+1)
+                > (successors[b].size()+1)*(predecessors[b].size()+1);
+    });
+
+    std::vector<std::vector<std::uint32_t>> outLabels(componentsNumber);
+    std::vector<std::vector<std::uint32_t>> inLabels(componentsNumber);
+    auto covered = [&](std::size_t from, std::size_t to)
+    {
+        return mIntersects(outLabels[from].data(),outLabels[from].data()+outLabels[from].size(),
+                           inLabels[to].data(),inLabels[to].data()+inLabels[to].size());
+    };
+
+    std::vector<std::size_t> visited(componentsNumber, std::numeric_limits<std::size_t>::max());
+    std::queue<std::size_t> q1;
+
+    for(std::size_t rank=0;rank<componentsNumber;++rank)
+    {
+        const std::size_t root = order[rank];
+        const std::uint32_t label = static_cast<std::uint32_t>(rank);
+
+        visited[root] = 2*rank;
+        q1.push(root);
+        while(!q1.empty())
+        {
+            std::size_t c = q1.front();
+            q1.pop();
+            if(c!=root && covered(root,c))continue;
+            inLabels[c].push_back(label);
+
+            for(std::size_t s: successors[c])
+            {
+                if(visited[s]!=2*rank)
+                {
+                    visited[s] = 2*rank;
+                    q1.push(s);
+                }
+            }
+        }
+
+        visited[root] = 2*rank+1;
+        q1.push(root);
+        while(!q1.empty())
+        {
+            std::size_t c = q1.front();
+            q1.pop();
+            if(c!=root && covered(c,root))continue;
+            outLabels[c].push_back(label);
+
+            for(std::size_t p: predecessors[c])
+            {
+                if(visited[p]!=2*rank+1)
+                {
+                    visited[p] = 2*rank+1;
+                    q1.push(p);
+                }
+            }
+        }
+    }
+
+    mFlatten(outLabels,this->mOutOffsets,this->mOutLabels);
+    mFlatten(inLabels,this->mInOffsets,this->mInLabels);
+}
@@ -0,0 +1,289 @@
+#pragma once
+#include "Graph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+// przenumerowanie wierzchołków tak, aby sąsiedzi mieli bliskie id - wiersze i kolumny macierzy sąsiedztwa
+// odwiedzane razem przez przejścia grafu leżą wtedy blisko siebie w pamięci
+// kierunek krawędzi jest pomijany (sąsiedzi "v" to wierzchołki połączone z "v" krawędzią w dowolną stronę)
+enum class ReorderStrategy
+{
+    // kolejność BFS, składowe od najmniejszego id, sąsiedzi rosnąco po id
+    BreadthFirst,
+    // odwrócony Cuthill-McKee: BFS z wierzchołka pseudo-peryferyjnego, sąsiedzi rosnąco po stopniu
+    // (zmniejsza szerokość pasma macierzy sąsiedztwa)
+    ReverseCuthillMcKee,
+    // malejąco po stopniu - wierzchołki o dużym stopniu (najczęściej odwiedzane) są obok siebie
+    DegreeSort,
+    // kolejność na krzywej Hilberta według współrzędnych wierzchołków
+    SpaceFillingCurve
+};
+
+// nieskierowane listy sąsiedztwa (CSR) bez pętli i powtórzeń, sąsiedzi rosnąco po id
+template<typename V, typename E>
+void reorderAdjacency(const Graph<V, E>& graph, std::vector<std::size_t>& offsets, std::vector<std::size_t>& neighbours)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    offsets.assign(verticesNumber+1,0);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x==y)continue;
+            ++offsets[y+1];
+            ++offsets[x+1];
+        }
+    }
+    for(std::size_t v=0;v<verticesNumber;++v) offsets[v+1] += offsets[v];
+
+    neighbours.resize(offsets[verticesNumber]);
+    std::vector<std::size_t> fill(offsets.begin(),offsets.end()-1);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x==y)continue;
+            neighbours[fill[y]++] = x;
+            neighbours[fill[x]++] = y;
+        }
+    }
+    // krawędź w obie strony daje sąsiada dwa razy - powtórzenia są usuwane, a listy dosuwane do siebie
+    std::size_t size = 0;
+    for(std::size_t v=0;v<verticesNumber;++v)
+    {
+        auto first = neighbours.begin()+offsets[v], last = neighbours.begin()+offsets[v+1];
+        std::sort(first,last);
+        last = std::unique(first,last);
+        offsets[v] = size;
+        size = std::copy(first,last,neighbours.begin()+size)-neighbours.begin();
+    }
+    offsets[verticesNumber] = size;
+    neighbours.resize(size);
+}
+
+// indeks punktu (x, y) na krzywej Hilberta wypełniającej kwadrat "side" x "side" ("side" - potęga 2)
+inline std::uint64_t hilbertIndex(std::uint32_t side, std::uint32_t x, std::uint32_t y)
+{
+    std::uint64_t d = 0;
+    for(std::uint32_t s=side/2;s>0;s/=2)
+    {
+        const std::uint32_t rx = (x&s)>0 ? 1 : 0;
+        const std::uint32_t ry = (y&s)>0 ? 1 : 0;
+        d += std::uint64_t(s)*s*((3*rx)^ry);
+        if(ry==0)
+        {
+            if(rx==1)
+            {
+                x = side-1-x;
+                y = side-1-y;
+            }
+            std::swap(x,y);
+        }
+    }
+    return d;
+}
+
+// zwraca nową kolejność wierzchołków: result[i] - dotychczasowe id wierzchołka, który dostanie id "i"
+// "getCoordinates" jest wymagane tylko dla "ReorderStrategy::SpaceFillingCurve"
+template<typename V, typename E>
+std::vector<std::size_t> vertexOrder(const Graph<V, E>& graph, ReorderStrategy strategy,
+                                     std::function<std::pair<double, double>(const typename Graph<V, E>::vertex_type&)>
+                                     getCoordinates = nullptr)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    std::vector<std::size_t> order;
+    order.reserve(verticesNumber);
+
+    if(strategy==ReorderStrategy::SpaceFillingCurve)
+    {
+        if(!getCoordinates)
+        {
+            throw std::runtime_error("[Reorder] Space filling curve requires vertex coordinates");
+        }
+        std::vector<std::pair<double, double>> points(verticesNumber);
+        double minX = std::numeric_limits<double>::max(), minY = minX;
+        double maxX = std::numeric_limits<double>::lowest(), maxY = maxX;
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            points[v] = getCoordinates(graph.vertexData(v));
+            if(!std::isfinite(points[v].first)||!std::isfinite(points[v].second))
+            {
+                throw std::runtime_error("[Reorder] Incorrect coordinates of vertex: "+std::to_string(v));
+            }
+            minX = std::min(minX,points[v].first);
+            maxX = std::max(maxX,points[v].first);
+            minY = std::min(minY,points[v].second);
+            maxY = std::max(maxY,points[v].second);
+        }
+
+        // współrzędne są skalowane (jednakowo w obu osiach) na siatkę 2^16 x 2^16
+        constexpr std::uint32_t SIDE = std::uint32_t(1)<<16;
+        const double extent = std::max(maxX-minX,maxY-minY);
+        const double scale = extent>0 ? (SIDE-1)/extent : 0.;
+        std::vector<std::pair<std::uint64_t, std::size_t>> keys(verticesNumber);
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            auto cx = static_cast<std::uint32_t>((points[v].first-minX)*scale);
+            auto cy = static_cast<std::uint32_t>((points[v].second-minY)*scale);
+            keys[v] = std::make_pair(hilbertIndex(SIDE,std::min(cx,SIDE-1),std::min(cy,SIDE-1)),v);
+        }
+        std::sort(keys.begin(),keys.end());
+        for(const auto& key: keys) order.push_back(key.second);
+        return order;
+    }
+
+    std::vector<std::size_t> offsets, neighbours;
+    reorderAdjacency(graph,offsets,neighbours);
+    auto degree = [&](std::size_t v)
+    {
+        return offsets[v+1]-offsets[v];
+    };
+
+    if(strategy==ReorderStrategy::DegreeSort)
+    {
+        for(std::size_t v=0;v<verticesNumber;++v) order.push_back(v);
+        std::stable_sort(order.begin(),order.end(),[&](std::size_t a, std::size_t b)
+        {
+            return degree(a)>degree(b);
+        });
+        return order;
+    }
+
+    std::vector<bool> placed(verticesNumber,false);
+
+    if(strategy==ReorderStrategy::BreadthFirst)
+    {
+        for(std::size_t root=0;root<verticesNumber;++root)
+        {
+            if(placed[root])continue;
+            placed[root] = true;
+            std::size_t head = order.size();
+            order.push_back(root);
+            for(;head<order.size();++head)
+            {
+                const std::size_t vId = order[head];
+                for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+                {
+                    if(!placed[neighbours[i]])
+                    {
+                        placed[neighbours[i]] = true;
+                        order.push_back(neighbours[i]);
+                    }
+                }
+            }
+        }
+        return order;
+    }
+
+    if(strategy!=ReorderStrategy::ReverseCuthillMcKee)
+    {
+        throw std::runtime_error("[Reorder] Unknown strategy");
+    }
+
+    // wspólne tablice przejść BFS, wpis jest ważny tylko gdy jego znacznik równa się "stamp"
+    std::vector<std::size_t> level(verticesNumber), levelStamp(verticesNumber,0), queue;
+    std::size_t stamp = 0;
+    queue.reserve(verticesNumber);
+    // BFS z "root" - zwraca liczbę poziomów, "queue" zawiera wierzchołki składowej
+    auto levelStructure = [&](std::size_t root)
+    {
+        ++stamp;
+        queue.clear();
+        queue.push_back(root);
+        level[root] = 0;
+        levelStamp[root] = stamp;
+        for(std::size_t head=0;head<queue.size();++head)
+        {
+            const std::size_t vId = queue[head];
+            for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+            {
+                const std::size_t x = neighbours[i];
+                if(levelStamp[x]==stamp)continue;
+                levelStamp[x] = stamp;
+                level[x] = level[vId]+1;
+                queue.push_back(x);
+            }
+        }
+        return level[queue.back()]+1;
+    };
+
+    // kandydaci na początki składowych: rosnąco po stopniu
+    std::vector<std::size_t> byDegree(verticesNumber);
+    for(std::size_t v=0;v<verticesNumber;++v) byDegree[v] = v;
+    std::stable_sort(byDegree.begin(),byDegree.end(),[&](std::size_t a, std::size_t b)
+    {
+        return degree(a)<degree(b);
+    });
+
+    std::vector<std::size_t> sortedNeighbours;
+    for(std::size_t candidate: byDegree)
+    {
+        if(placed[candidate])continue;
+
+        // wierzchołek pseudo-peryferyjny (George, Liu): przechodzimy do wierzchołka o najmniejszym
+        // stopniu z ostatniego poziomu, dopóki rośnie liczba poziomów
+        std::size_t root = candidate;
+        std::size_t depth = levelStructure(root);
+        while(true)
+        {
+            std::size_t next = root;
+            for(std::size_t i=queue.size();i-->0&&level[queue[i]]+1==depth;)
+            {
+                if(next==root||degree(queue[i])<degree(next)||
+                   (degree(queue[i])==degree(next)&&queue[i]<next))next = queue[i];
+            }
+            if(next==root)break;
+            const std::size_t nextDepth = levelStructure(next);
+            if(nextDepth<=depth)break;
+            root = next;
+            depth = nextDepth;
+        }
+
+        // Cuthill-McKee: BFS z "root", nieodwiedzeni sąsiedzi dopisywani rosnąco po stopniu
+        placed[root] = true;
+        std::size_t head = order.size();
+        order.push_back(root);
+        for(;head<order.size();++head)
+        {
+            const std::size_t vId = order[head];
+            sortedNeighbours.clear();
+            for(std::size_t i=offsets[vId];i<offsets[vId+1];++i)
+            {
+                if(!placed[neighbours[i]])
+                {
+                    placed[neighbours[i]] = true;
+                    sortedNeighbours.push_back(neighbours[i]);
+                }
+            }
+            std::stable_sort(sortedNeighbours.begin(),sortedNeighbours.end(),[&](std::size_t a, std::size_t b)
+            {
+                return degree(a)<degree(b);
+            });
+            order.insert(order.end(),sortedNeighbours.begin(),sortedNeighbours.end());
+        }
+    }
+    std::reverse(order.begin(),order.end());
+    return order;
+}
+
+// przenumerowuje wierzchołki grafu (dane i krawędzie są fizycznie przestawiane, patrz "Graph::permuteVertices()")
+// zwraca (stare id -> nowe id, nowe id -> stare id)
+// id zapamiętane poza grafem tracą ważność i trzeba je przeliczyć (dziennik zmian jest czyszczony,
+// więc np. "DynamicShortestPaths" zgłasza wyjątek przy następnym zapytaniu)
+template<typename V, typename E>
+std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+reorder(Graph<V, E>& graph, ReorderStrategy strategy,
+        std::function<std::pair<double, double>(const typename Graph<V, E>::vertex_type&)>
+        getCoordinates = nullptr)
+{
+    std::vector<std::size_t> newToOld = vertexOrder(graph,strategy,getCoordinates);
+    std::vector<std::size_t> oldToNew(newToOld.size());
+    for(std::size_t i=0;i<newToOld.size();++i) oldToNew[newToOld[i]] = i;
+
+    graph.permuteVertices(oldToNew);
+    return std::make_pair(std::move(oldToNew),std::move(newToOld));
+}
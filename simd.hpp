@@ -0,0 +1,48 @@
+#pragma once
+
+// wybór ścieżek SIMD
+// GCC/Clang na x86-64: ścieżki AVX2 i AVX-512 są kompilowane atrybutem "target", niezależnie od flag kompilatora
+// (nie wymagają "-mavx2"), i wybierane w czasie działania według "__builtin_cpu_supports()" - ten sam plik
+// wykonywalny działa na każdym procesorze x86-64, a szersze rejestry są używane tam, gdzie są dostępne
+// pozostałe kompilatory: ścieżki są wybierane w czasie kompilacji (np. MSVC "/arch:AVX2")
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+
+#define GRAPH_SIMD_TARGET(features) __attribute__((target(features)))
+#define GRAPH_SIMD_AVX2
+#define GRAPH_SIMD_AVX512_POPCOUNT
+
+// zestawy instrukcji procesora są sprawdzane raz
+inline bool cpuSupportsAvx2()
+{
+    static const bool supported = (__builtin_cpu_init(),__builtin_cpu_supports("avx2")!=0);
+    return supported;
+}
+inline bool cpuSupportsAvx512Popcount()
+{
+    static const bool supported = (__builtin_cpu_init(),__builtin_cpu_supports("avx512f")!=0 &&
+                                   __builtin_cpu_supports("avx512vpopcntdq")!=0);
+    return supported;
+}
+#else
+#if defined(__AVX2__) || defined(__AVX512F__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#define GRAPH_SIMD_TARGET(features)
+
+#if defined(__AVX2__)
+#define GRAPH_SIMD_AVX2
+inline bool cpuSupportsAvx2()
+{
+    return true;
+}
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#define GRAPH_SIMD_AVX512_POPCOUNT
+inline bool cpuSupportsAvx512Popcount()
+{
+    return true;
+}
+#endif
+#endif
@@ -0,0 +1,242 @@
+#pragma once
+// śledzenie czasu faz algorytmów i modyfikacji grafu (odcinki czasu, "spans")
+// włączane przy kompilacji: -DGRAPH_TRACING (bez tej flagi makra GRAPH_TRACE_* nie generują żadnego kodu)
+// - każdy wątek zapisuje zdarzenia do własnego bufora cyklicznego bez blokad (najstarsze są nadpisywane),
+//   rozmiar bufora: GRAPH_TRACE_BUFFER_SIZE zdarzeń (potęga 2)
+// - "Tracer::instance().writeChromeTrace(os)" zapisuje zebrane zdarzenia w formacie Chrome Trace Event (JSON),
+//   do obejrzenia w chrome://tracing lub Perfetto; eksport może działać równolegle z zapisem zdarzeń
+//   (zdarzenia nadpisywane w trakcie kopiowania są pomijane)
+//
+// GRAPH_TRACE_SPAN(span, "kategoria", "nazwa") - odcinek od tego miejsca do końca zasięgu
+// GRAPH_TRACE_NEXT(span, "nazwa") - kończy bieżący odcinek "span" i zaczyna następny (kolejne fazy)
+#if defined(GRAPH_TRACING)
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef GRAPH_TRACE_BUFFER_SIZE
+#define GRAPH_TRACE_BUFFER_SIZE (1<<16)
+#endif
+
+class Tracer
+{
+public:
+    static constexpr std::size_t BUFFER_SIZE = GRAPH_TRACE_BUFFER_SIZE;
+    static_assert((BUFFER_SIZE&(BUFFER_SIZE-1))==0,"GRAPH_TRACE_BUFFER_SIZE must be a power of 2");
+
+    static Tracer& instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // nanosekundy od utworzenia "Tracer"
+    std::uint64_t now() const
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now()-this->mEpoch).count());
+    }
+
+    // zapisuje zakończony odcinek w buforze bieżącego wątku
+    // "name" i "category" muszą żyć do eksportu (zwykle literały)
+    void record(const char* name, const char* category, std::uint64_t start, std::uint64_t end)
+    {
+        if(!this->mEnabled.load(std::memory_order_relaxed))return;
+        this->mThreadBuffer().push(name,category,start,end);
+    }
+
+    void setEnabled(bool enabled)
+    {
+        this->mEnabled = enabled;
+    }
+    bool enabled() const
+    {
+        return this->mEnabled.load();
+    }
+
+    // usuwa zebrane zdarzenia (nie może działać równolegle z zapisem)
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mBuffersMutex);
+        for(auto& buffer: this->mBuffers) buffer->head.store(0);
+    }
+
+    // liczba zdarzeń utraconych przez nadpisanie (suma po wątkach)
+    std::uint64_t overwritten() const
+    {
+        std::lock_guard<std::mutex> lock(this->mBuffersMutex);
+        std::uint64_t result = 0;
+        for(auto& buffer: this->mBuffers)
+        {
+            const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+            if(head>BUFFER_SIZE) result += head-BUFFER_SIZE;
+        }
+        return result;
+    }
+
+    void writeChromeTrace(std::ostream& os) const
+    {
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(this->mBuffersMutex);
+            buffers = this->mBuffers;
+        }
+
+        os<<"{\"traceEvents\":[";
+        bool first = true;
+        for(std::size_t tid=0;tid<buffers.size();++tid)
+        {
+            const Buffer& buffer = *buffers[tid];
+            const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+            const std::uint64_t begin = head>BUFFER_SIZE ? head-BUFFER_SIZE : 0;
+            for(std::uint64_t i=begin;i<head;++i)
+            {
+                Event event;
+                if(!buffer.read(i,event))continue;
+                os<<(first ? "\n" : ",\n");
+                first = false;
+                os<<"{\"name\":\""<<event.name<<"\",\"cat\":\""<<event.category
+                 <<"\",\"ph\":\"X\",\"pid\":1,\"tid\":"<<tid
+                 <<",\"ts\":"<<mMicroseconds(event.start)
+                 <<",\"dur\":"<<mMicroseconds(event.end-event.start)<<"}";
+            }
+        }
+        os<<"\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+    // zwraca false, jeśli pliku nie udało się zapisać
+    bool writeChromeTrace(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if(!file)return false;
+        this->writeChromeTrace(file);
+        return static_cast<bool>(file);
+    }
+private:
+    class Event
+    {
+    public:
+        const char* name;
+        const char* category;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    // bufor cykliczny jednego wątku: jeden pisarz, dowolnie wielu czytelników
+    // każde pole ma numer sekwencyjny (nieparzysty w trakcie zapisu) - czytelnik odrzuca pola zmienione w trakcie kopiowania
+    class Buffer
+    {
+    public:
+        class Slot
+        {
+        public:
+            std::atomic<std::uint64_t> sequence{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<const char*> category{nullptr};
+            std::atomic<std::uint64_t> start{0};
+            std::atomic<std::uint64_t> end{0};
+        };
+
+        std::unique_ptr<Slot[]> slots{new Slot[BUFFER_SIZE]};
+        // liczba wszystkich zapisanych zdarzeń
+        std::atomic<std::uint64_t> head{0};
+
+        void push(const char* name, const char* category, std::uint64_t start, std::uint64_t end)
+        {
+            const std::uint64_t i = this->head.load(std::memory_order_relaxed);
+            Slot& slot = this->slots[i&(BUFFER_SIZE-1)];
+            slot.sequence.store(2*i+1,std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(name,std::memory_order_relaxed);
+            slot.category.store(category,std::memory_order_relaxed);
+            slot.start.store(start,std::memory_order_relaxed);
+            slot.end.store(end,std::memory_order_relaxed);
+            slot.sequence.store(2*i+2,std::memory_order_release);
+            this->head.store(i+1,std::memory_order_release);
+        }
+        // kopiuje i-te zdarzenie, zwraca false jeśli zostało już nadpisane
+        bool read(std::uint64_t i, Event& event) const
+        {
+            const Slot& slot = this->slots[i&(BUFFER_SIZE-1)];
+            if(slot.sequence.load(std::memory_order_acquire)!=2*i+2)return false;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.category = slot.category.load(std::memory_order_relaxed);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.end = slot.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.sequence.load(std::memory_order_relaxed)==2*i+2;
+        }
+    };
+
+    Tracer()
+        :mEpoch(std::chrono::steady_clock::now()),mEnabled(true)
+    {
+
+    }
+
+    const std::chrono::steady_clock::time_point mEpoch;
+    std::atomic<bool> mEnabled;
+    mutable std::mutex mBuffersMutex;
+    // bufory zakończonych wątków są zachowywane do eksportu
+    std::vector<std::shared_ptr<Buffer>> mBuffers;
+
+    // bufor jest rejestrowany przy pierwszym zdarzeniu wątku
+    Buffer& mThreadBuffer()
+    {
+        thread_local std::shared_ptr<Buffer> buffer;
+        if(!buffer)
+        {
+            buffer = std::make_shared<Buffer>();
+            std::lock_guard<std::mutex> lock(this->mBuffersMutex);
+            this->mBuffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    static std::string mMicroseconds(std::uint64_t ns)
+    {
+        std::string result = std::to_string(ns/1000)+".";
+        const std::string fraction = std::to_string(ns%1000);
+        return result+std::string(3-fraction.size(),'0')+fraction;
+    }
+};
+
+// odcinek czasu zapisywany przy zniszczeniu (lub przy przejściu do następnej fazy)
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category)
+        :mName(name),mCategory(category),mStart(Tracer::instance().now())
+    {
+
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    ~TraceSpan()
+    {
+        Tracer::instance().record(this->mName,this->mCategory,this->mStart,Tracer::instance().now());
+    }
+    void next(const char* name)
+    {
+        const std::uint64_t now = Tracer::instance().now();
+        Tracer::instance().record(this->mName,this->mCategory,this->mStart,now);
+        this->mName = name;
+        this->mStart = now;
+    }
+private:
+    const char* mName;
+    const char* mCategory;
+    std::uint64_t mStart;
+};
+
+#define GRAPH_TRACE_SPAN(span, category, name) TraceSpan span(name,category)
+#define GRAPH_TRACE_NEXT(span, name) span.next(name)
+#else
+#define GRAPH_TRACE_SPAN(span, category, name) ((void)0)
+#define GRAPH_TRACE_NEXT(span, name) ((void)0)
+#endif
@@ -0,0 +1,383 @@
+#pragma once
+// leniwe przejścia grafu jako korutyny C++20 - nagłówek jest pusty przy kompilacji w C++17
+// (projekt kompiluje się jako C++17; aby ich użyć, trzeba kompilować jako C++20, np. "CONFIG += c++2a")
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include "Graph.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <ranges>
+#include <unordered_map>
+
+// pamięć na ramki korutyn: bloki przydzielane kolejno, a zwolnione ramki trafiają na listy wolnych
+// według rozmiaru (ramki tej samej korutyny mają ten sam rozmiar, więc są używane ponownie bez alokacji)
+// nie jest bezpieczna wątkowo - jedna arena na wątek; ramki muszą zostać zwolnione przed zniszczeniem areny
+class CoroutineArena
+{
+public:
+    explicit CoroutineArena(std::size_t blockSize = 1<<16)
+        :mBlockSize(blockSize),mCurrent(nullptr),mRemaining(0)
+    {
+
+    }
+    CoroutineArena(const CoroutineArena&) = delete;
+    CoroutineArena& operator=(const CoroutineArena&) = delete;
+
+    // ramka z nagłówkiem wskazującym arenę ("arena" == nullptr - zwykły operator new)
+    static void* allocateFrame(CoroutineArena* arena, std::size_t size)
+    {
+        const std::size_t total = HEADER_SIZE+size;
+        void* memory = arena!=nullptr ? arena->mAllocate(total) : ::operator new(total);
+        *static_cast<CoroutineArena**>(memory) = arena;
+        return static_cast<std::byte*>(memory)+HEADER_SIZE;
+    }
+    static void deallocateFrame(void* frame, std::size_t size)
+    {
+        void* memory = static_cast<std::byte*>(frame)-HEADER_SIZE;
+        CoroutineArena* arena = *static_cast<CoroutineArena**>(memory);
+        if(arena!=nullptr) arena->mDeallocate(memory,HEADER_SIZE+size);
+        else ::operator delete(memory);
+    }
+
+    std::size_t blocksNumber() const
+    {
+        return this->mBlocks.size();
+    }
+private:
+    static constexpr std::size_t ALIGNMENT = alignof(std::max_align_t);
+    static constexpr std::size_t HEADER_SIZE = (sizeof(CoroutineArena*)+ALIGNMENT-1)/ALIGNMENT*ALIGNMENT;
+
+    std::size_t mBlockSize;
+    std::vector<std::unique_ptr<std::byte[]>> mBlocks;
+    std::byte* mCurrent;
+    std::size_t mRemaining;
+    // rozmiar -> pierwsza wolna ramka (kolejne są połączone przez swoje pierwsze bajty)
+    std::unordered_map<std::size_t, void*> mFree;
+
+    static std::size_t mRounded(std::size_t size)
+    {
+        return (size+ALIGNMENT-1)/ALIGNMENT*ALIGNMENT;
+    }
+    void* mAllocate(std::size_t size)
+    {
+        size = mRounded(size);
+        auto it = this->mFree.find(size);
+        if(it!=this->mFree.end()&&it->second!=nullptr)
+        {
+            void* memory = it->second;
+            it->second = *static_cast<void**>(memory);
+            return memory;
+        }
+        if(this->mRemaining<size)
+        {
+            const std::size_t blockSize = std::max(this->mBlockSize,size);
+            this->mBlocks.emplace_back(new std::byte[blockSize]);
+            this->mCurrent = this->mBlocks.back().get();
+            this->mRemaining = blockSize;
+        }
+        void* memory = this->mCurrent;
+        this->mCurrent += size;
+        this->mRemaining -= size;
+        return memory;
+    }
+    void mDeallocate(void* memory, std::size_t size)
+    {
+        void*& head = this->mFree[mRounded(size)];
+        *static_cast<void**>(memory) = head;
+        head = memory;
+    }
+};
+
+// generator w stylu std::generator (C++23): leniwy zakres wartości zwracanych przez "co_yield"
+// jest widokiem jednoprzebiegowym (std::ranges::input_range), więc składa się z widokami std::views
+// ramka korutyny jest przydzielana z areny, jeśli wśród argumentów korutyny jest "CoroutineArena*" różny od nullptr
+template<typename T>
+class Generator: public std::ranges::view_base
+{
+public:
+    class promise_type
+    {
+    public:
+        const T* value = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object()
+        {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+        // wartość (również tymczasowa) żyje do wznowienia korutyny
+        std::suspend_always yield_value(const T& v) noexcept
+        {
+            this->value = std::addressof(v);
+            return {};
+        }
+        void return_void() noexcept
+        {
+
+        }
+        void unhandled_exception()
+        {
+            this->error = std::current_exception();
+        }
+        void await_transform() = delete;
+
+        template<typename... Args>
+        static void* operator new(std::size_t size, const Args&... args)
+        {
+            CoroutineArena* arena = nullptr;
+            ((arena = mArenaOf(args,arena)),...);
+            return CoroutineArena::allocateFrame(arena,size);
+        }
+        static void* operator new(std::size_t size)
+        {
+            return CoroutineArena::allocateFrame(nullptr,size);
+        }
+        static void operator delete(void* frame, std::size_t size)
+        {
+            CoroutineArena::deallocateFrame(frame,size);
+        }
+    private:
+        static CoroutineArena* mArenaOf(CoroutineArena* arena, CoroutineArena* previous)
+        {
+            return arena!=nullptr ? arena : previous;
+        }
+        template<typename A>
+        static CoroutineArena* mArenaOf(const A&, CoroutineArena* previous)
+        {
+            return previous;
+        }
+    };
+
+    class iterator
+    {
+        friend class Generator;
+        explicit iterator(std::coroutine_handle<promise_type> handle)
+            :mHandle(handle)
+        {
+
+        }
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        const T& operator*() const
+        {
+            return *this->mHandle.promise().value;
+        }
+        iterator& operator++()
+        {
+            this->mHandle.resume();
+            this->mRethrow();
+            return *this;
+        }
+        void operator++(int)
+        {
+            ++*this;
+        }
+        friend bool operator==(const iterator& it, std::default_sentinel_t)
+        {
+            return !it.mHandle||it.mHandle.done();
+        }
+    private:
+        std::coroutine_handle<promise_type> mHandle;
+
+        void mRethrow() const
+        {
+            if(this->mHandle.done()&&this->mHandle.promise().error)
+            {
+                std::rethrow_exception(this->mHandle.promise().error);
+            }
+        }
+    };
+
+    Generator() = default;
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& source) noexcept
+        :mHandle(std::exchange(source.mHandle,nullptr))
+    {
+
+    }
+    Generator& operator=(Generator&& source) noexcept
+    {
+        if(this!=&source)
+        {
+            if(this->mHandle)this->mHandle.destroy();
+            this->mHandle = std::exchange(source.mHandle,nullptr);
+        }
+        return *this;
+    }
+    ~Generator()
+    {
+        if(this->mHandle)this->mHandle.destroy();
+    }
+
+    // uruchamia korutynę do pierwszej wartości - wolno wywołać tylko raz
+    iterator begin()
+    {
+        iterator it(this->mHandle);
+        if(this->mHandle)
+        {
+            this->mHandle.resume();
+            it.mRethrow();
+        }
+        return it;
+    }
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle)
+        :mHandle(handle)
+    {
+
+    }
+    std::coroutine_handle<promise_type> mHandle = nullptr;
+};
+
+// przejścia zwracają id wierzchołków osiągalnych z "startID", sąsiedzi są rozpatrywani rosnąco po id
+// graf nie może być zmieniany ani niszczony, dopóki generator jest używany
+// praca jest wykonywana tylko dla pobranych wierzchołków - sąsiedzi pobranego wierzchołka są wyliczani
+// przez "Graph::nextNeighbor()", który pomija puste słowa wiersza
+
+// DFS (preorder)
+template<typename V, typename E>
+Generator<std::size_t> dfsVertices(const Graph<V, E>& graph, std::size_t startID,
+                                   [[maybe_unused]] CoroutineArena* arena = nullptr)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(startID>=verticesNumber)
+        throw std::runtime_error("[DFS] Incorrect startID:"+std::to_string(startID));
+
+    std::vector<bool> visited(verticesNumber,false);
+    // stos (wierzchołek, następny sprawdzany sąsiad)
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    visited[startID] = true;
+    stack.emplace_back(startID,0);
+    co_yield startID;
+
+    while(!stack.empty())
+    {
+        auto& [vId, next] = stack.back();
+        next = graph.nextNeighbor(vId,next);
+        while(next<verticesNumber&&visited[next]) next = graph.nextNeighbor(vId,next+1);
+        if(next==verticesNumber)
+        {
+            stack.pop_back();
+            continue;
+        }
+        const std::size_t x = next++;
+        visited[x] = true;
+        stack.emplace_back(x,0);
+        co_yield x;
+    }
+}
+
+// BFS
+template<typename V, typename E>
+Generator<std::size_t> bfsVertices(const Graph<V, E>& graph, std::size_t startID,
+                                   [[maybe_unused]] CoroutineArena* arena = nullptr)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(startID>=verticesNumber)
+        throw std::runtime_error("[BFS] Incorrect startID:"+std::to_string(startID));
+
+    std::vector<bool> visited(verticesNumber,false);
+    std::queue<std::size_t> q1;
+    visited[startID] = true;
+    q1.push(startID);
+    while(!q1.empty())
+    {
+        const std::size_t vId = q1.front();
+        q1.pop();
+        co_yield vId;
+        for(std::size_t x=graph.nextNeighbor(vId,0);x<verticesNumber;x=graph.nextNeighbor(vId,x+1))
+        {
+            if(!visited[x])
+            {
+                visited[x] = true;
+                q1.push(x);
+            }
+        }
+    }
+}
+
+// BFS ograniczony do wierzchołków odległych o co najwyżej "maxDepth" krawędzi
+template<typename V, typename E>
+Generator<std::size_t> boundedVertices(const Graph<V, E>& graph, std::size_t startID, std::size_t maxDepth,
+                                       [[maybe_unused]] CoroutineArena* arena = nullptr)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(startID>=verticesNumber)
+        throw std::runtime_error("[BFS] Incorrect startID:"+std::to_string(startID));
+
+    std::vector<bool> visited(verticesNumber,false);
+    std::vector<std::size_t> level{startID}, nextLevel;
+    visited[startID] = true;
+    for(std::size_t depth=0;!level.empty();++depth)
+    {
+        for(std::size_t vId: level)
+        {
+            co_yield vId;
+            if(depth==maxDepth)continue;
+            for(std::size_t x=graph.nextNeighbor(vId,0);x<verticesNumber;x=graph.nextNeighbor(vId,x+1))
+            {
+                if(!visited[x])
+                {
+                    visited[x] = true;
+                    nextLevel.push_back(x);
+                }
+            }
+        }
+        level.swap(nextLevel);
+        nextLevel.clear();
+    }
+}
+
+// najlepszy pierwszy: zawsze wierzchołek o najmniejszym "priority(id)" spośród sąsiadów już zwróconych
+// (przy równych priorytetach - mniejsze id)
+template<typename V, typename E>
+Generator<std::size_t> bestFirstVertices(const Graph<V, E>& graph, std::size_t startID,
+                                         std::function<double(std::size_t)> priority,
+                                         [[maybe_unused]] CoroutineArena* arena = nullptr)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    if(startID>=verticesNumber)
+        throw std::runtime_error("[Best first] Incorrect startID:"+std::to_string(startID));
+
+    using QueueEntry = std::pair<double, std::size_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> q1;
+    std::vector<bool> visited(verticesNumber,false);
+    visited[startID] = true;
+    q1.emplace(priority(startID),startID);
+    while(!q1.empty())
+    {
+        const std::size_t vId = q1.top().second;
+        q1.pop();
+        co_yield vId;
+        for(std::size_t x=graph.nextNeighbor(vId,0);x<verticesNumber;x=graph.nextNeighbor(vId,x+1))
+        {
+            if(!visited[x])
+            {
+                visited[x] = true;
+                q1.emplace(priority(x),x);
+            }
+        }
+    }
+}
+
+#endif
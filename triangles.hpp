@@ -0,0 +1,196 @@
+#pragma once
+#include "Graph.hpp"
+#include "BitMatrix.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// liczenie trójkątów i lokalne współczynniki gronowania (clustering coefficient)
+// krawędzie grafu są traktowane jako nieskierowane: u i v są sąsiadami, jeśli istnieje krawędź u->v lub v->u,
+// pętle są pomijane
+enum class TriangleMethod
+{
+    // zbiory bitowe gdy średni stopień >= V / 64 (gęsty graf), w przeciwnym razie scalanie list
+    Automatic,
+    // wiersze macierzy sąsiedztwa upakowane w słowa: trójkąty przez v i sąsiada u to popcount(N(v) & N(u)),
+    // O(E * V / 64), popcount AVX2 / AVX-512 (patrz "bitsAndCount()")
+    Bitset,
+    // posortowane listy sąsiedztwa skierowane od wierzchołka o mniejszym stopniu do większego -
+    // każdy trójkąt jest znajdowany raz przez scalanie dwóch list, O(E^1.5)
+    Merge
+};
+
+// wynik "triangles()"
+class TriangleCounts
+{
+public:
+    // liczba trójkątów w grafie
+    std::uint64_t total;
+    // liczba trójkątów zawierających wierzchołek (według id)
+    std::vector<std::uint64_t> vertices;
+    // liczba sąsiadów wierzchołka (bez pętli, sąsiad w obie strony liczy się raz)
+    std::vector<std::size_t> degrees;
+};
+
+template<typename V, typename E>
+TriangleCounts triangles(const Graph<V, E>& graph, TriangleMethod method = TriangleMethod::Automatic,
+                         std::size_t threadsNumber = 0)
+{
+    const std::size_t verticesNumber = graph.nrOfVertices();
+    TriangleCounts result;
+    result.total = 0;
+    result.vertices.assign(verticesNumber,0);
+    result.degrees.assign(verticesNumber,0);
+
+    // nieskierowane listy sąsiedztwa (CSR) bez pętli i powtórzeń, sąsiedzi rosnąco po id
+    std::vector<std::size_t> offsets(verticesNumber+1,0);
+    for(std::size_t y=0;y<verticesNumber;++y)
+    {
+        for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+        {
+            if(x==y)continue;
+            ++offsets[y+1];
+            ++offsets[x+1];
+        }
+    }
+    for(std::size_t v=0;v<verticesNumber;++v) offsets[v+1] += offsets[v];
+    std::vector<std::size_t> neighbours(offsets[verticesNumber]);
+    {
+        std::vector<std::size_t> fill(offsets.begin(),offsets.end()-1);
+        for(std::size_t y=0;y<verticesNumber;++y)
+        {
+            for(std::size_t x=graph.nextNeighbor(y,0);x<verticesNumber;x=graph.nextNeighbor(y,x+1))
+            {
+                if(x==y)continue;
+                neighbours[fill[y]++] = x;
+                neighbours[fill[x]++] = y;
+            }
+        }
+    }
+    // krawędź w obie strony daje sąsiada dwa razy
+    parallelFor(0,verticesNumber,[&](std::size_t v)
+    {
+        auto first = neighbours.begin()+offsets[v], last = neighbours.begin()+offsets[v+1];
+        std::sort(first,last);
+        result.degrees[v] = std::unique(first,last)-first;
+    },threadsNumber,64);
+
+    std::size_t degreesSum = 0;
+    for(std::size_t v=0;v<verticesNumber;++v) degreesSum += result.degrees[v];
+    if(method==TriangleMethod::Automatic)
+    {
+        // średni stopień 2E / V >= V / 64
+        method = degreesSum*BitMatrix::WORD_BITS>=verticesNumber*verticesNumber
+                ? TriangleMethod::Bitset : TriangleMethod::Merge;
+    }
+
+    if(method==TriangleMethod::Bitset)
+    {
+        BitMatrix adjacency(verticesNumber,verticesNumber);
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            for(std::size_t i=offsets[v];i<offsets[v]+result.degrees[v];++i) adjacency.set(v,neighbours[i]);
+        }
+        // każdy trójkąt przez v jest liczony z obu pozostałych wierzchołków
+        parallelFor(0,verticesNumber,[&](std::size_t v)
+        {
+            std::uint64_t count = 0;
+            for(std::size_t i=offsets[v];i<offsets[v]+result.degrees[v];++i)
+            {
+                count += bitsAndCount(adjacency.row(v),adjacency.row(neighbours[i]),adjacency.wordsPerRow());
+            }
+            result.vertices[v] = count/2;
+        },threadsNumber,16);
+    }
+    else
+    {
+        // ranga: (stopień, id) - sąsiedzi "wyżsi" od v to ci o większej randze
+        auto higher = [&](std::size_t u, std::size_t v)
+        {
+            return result.degrees[u]!=result.degrees[v] ? result.degrees[u]>result.degrees[v] : u>v;
+        };
+        std::vector<std::size_t> forwardOffsets(verticesNumber+1,0);
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            std::size_t count = 0;
+            for(std::size_t i=offsets[v];i<offsets[v]+result.degrees[v];++i)
+            {
+                if(higher(neighbours[i],v))++count;
+            }
+            forwardOffsets[v+1] = forwardOffsets[v]+count;
+        }
+        std::vector<std::size_t> forward(forwardOffsets[verticesNumber]);
+        for(std::size_t v=0;v<verticesNumber;++v)
+        {
+            std::size_t j = forwardOffsets[v];
+            for(std::size_t i=offsets[v];i<offsets[v]+result.degrees[v];++i)
+            {
+                if(higher(neighbours[i],v)) forward[j++] = neighbours[i];
+            }
+        }
+
+        // trójkąt (v, u, w) o rosnących rangach jest znajdowany raz, z wierzchołka v
+        // wątki pobierają wierzchołki porcjami i liczą trójkąty we własnych tablicach
+        const std::size_t workersNumber = std::max<std::size_t>(
+                    std::min(threadsNumberOrDefault(threadsNumber),(verticesNumber+63)/64),1);
+        std::vector<std::vector<std::uint64_t>> counts(workersNumber);
+        std::atomic<std::size_t> next(0);
+        parallelFor(0,workersNumber,[&](std::size_t t)
+        {
+            std::vector<std::uint64_t>& count = counts[t];
+            count.assign(verticesNumber,0);
+            while(true)
+            {
+                const std::size_t first = next.fetch_add(64);
+                if(first>=verticesNumber)break;
+                for(std::size_t v=first;v<std::min(first+64,verticesNumber);++v)
+                {
+                    for(std::size_t i=forwardOffsets[v];i<forwardOffsets[v+1];++i)
+                    {
+                        const std::size_t u = forward[i];
+                        std::size_t a = forwardOffsets[v], b = forwardOffsets[u];
+                        while(a<forwardOffsets[v+1]&&b<forwardOffsets[u+1])
+                        {
+                            if(forward[a]<forward[b])++a;
+                            else if(forward[b]<forward[a])++b;
+                            else
+                            {
+                                ++count[v];
+                                ++count[u];
+                                ++count[forward[a]];
+                                ++a;
+                                ++b;
+                            }
+                        }
+                    }
+                }
+            }
+        },workersNumber,1);
+
+        for(std::size_t t=0;t<workersNumber;++t)
+        {
+            for(std::size_t v=0;v<verticesNumber;++v) result.vertices[v] += counts[t][v];
+        }
+    }
+
+    for(std::size_t v=0;v<verticesNumber;++v) result.total += result.vertices[v];
+    result.total /= 3;
+    return result;
+}
+
+// lokalne współczynniki gronowania: liczba trójkątów przez v / liczba par sąsiadów v (0 gdy v ma mniej niż 2 sąsiadów)
+template<typename V, typename E>
+std::vector<double> clusteringCoefficients(const Graph<V, E>& graph, TriangleMethod method = TriangleMethod::Automatic,
+                                           std::size_t threadsNumber = 0)
+{
+    const TriangleCounts counts = triangles(graph,method,threadsNumber);
+    std::vector<double> result(counts.vertices.size(),0.);
+    for(std::size_t v=0;v<result.size();++v)
+    {
+        const double degree = static_cast<double>(counts.degrees[v]);
+        if(counts.degrees[v]>=2) result[v] = 2.*static_cast<double>(counts.vertices[v])/(degree*(degree-1.));
+    }
+    return result;
+}